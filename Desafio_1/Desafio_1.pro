@@ -5,15 +5,40 @@ SOURCES += \
     src/main.cpp \
     src/solver.cpp \
     src/app.cpp \
-    src/compress.cpp
+    src/compress.cpp \
+    src/kernels.cpp \
+    src/input.cpp \
+    src/batch.cpp \
+    src/trace.cpp \
+    src/keycache.cpp \
+    src/matcher.cpp \
+    src/output.cpp
 
 HEADERS += \
     include/solver.hpp \
+    include/solver_internal.hpp \
     include/app.hpp \
-    include/compress.hpp
+    include/compress.hpp \
+    include/kernels.hpp \
+    include/input.hpp \
+    include/batch.hpp \
+    include/trace.hpp \
+    include/keycache.hpp \
+    include/matcher.hpp \
+    include/output.hpp
+
+# Modo demonio: socket Unix, solo en sistemas POSIX
+unix {
+    SOURCES += src/daemon.cpp
+    HEADERS += include/daemon.hpp
+    DEFINES += DESAFIO_DAEMON
+}
 
 INCLUDEPATH += include
 
+# Contadores por etapa y traza Chrome: qmake CONFIG+=trace
+trace: DEFINES += DESAFIO_TRACE
+
 # Carpetas de salida
 DESTDIR     = bin        # ejecutable
 OBJECTS_DIR = build      # objetos intermedios (.o)
@@ -0,0 +1,572 @@
+/**
+ * @file bench.cpp
+ * @brief Microbenchmarks de los kernels de desencriptado, búsqueda y descompresión.
+ *
+ * Ejecuta cada kernel sobre entradas sintéticas desde 1 KB hasta 1 GB (por defecto) y
+ * reporta el rendimiento en MB/s, el tiempo por llamada, el tiempo por candidato (n, k)
+ * en las etapas que recorren el espacio de claves y la cantidad de reservas de memoria
+ * por llamada (contadas reemplazando `operator new`).
+ *
+ * Uso:
+ * @code{.txt}
+ * ./Desafio_1_bench [--min bytes] [--max bytes] [--only nombre] [--time segundos]
+ * ./Desafio_1_bench --verify
+ * @endcode
+ *
+ * Con `--verify` no mide nada: compara la salida de cada versión de los kernels
+ * (`kernels_force_isa()`) contra la escalar sobre VERIFY_SIZE bytes aleatorios, con todas
+ * las rotaciones, varias claves, longitudes y desplazamientos que dejan colas sin
+ * alinear y desencriptado en el mismo buffer. Termina con código 1 ante la primera diferencia.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <solver_internal.hpp>
+#include <kernels.hpp>
+#include <compress.hpp>
+#include <matcher.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// ====== Contador de reservas de memoria ============
+
+static atomic<size_t> g_allocs(0);
+
+// new y new[] reservan con malloc directamente para que cada delete (free) se empareje
+// con su reserva
+static void *counted_alloc(size_t size)
+{
+    g_allocs.fetch_add(1, memory_order_relaxed);
+    void *p = malloc(size ? size : 1);
+    if (!p)
+    {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void *operator new(size_t size)
+{
+    return counted_alloc(size);
+}
+
+void *operator new[](size_t size)
+{
+    return counted_alloc(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+    // Clave usada para cifrar las entradas sintéticas: cerca del final del orden serial
+    const uint8_t BENCH_N = 7;
+    const uint8_t BENCH_K = 0xF0;
+
+    // Bytes aleatorios para `--verify`
+    const size_t VERIFY_SIZE = (size_t)8 << 20;
+
+    /**
+     * @struct bench_opts_t
+     * @brief Opciones de la línea de comandos.
+     */
+    typedef struct {
+        size_t min_size;        /**< Tamaño mínimo de entrada. */
+        size_t max_size;        /**< Tamaño máximo de entrada. */
+        const char *only;       /**< Solo kernels cuyo nombre contenga este texto. */
+        double min_time;        /**< Tiempo mínimo de medición por kernel y tamaño. */
+    } bench_opts_t;
+
+    /**
+     * @struct bench_input_t
+     * @brief Entradas sintéticas de un tamaño dado.
+     */
+    typedef struct {
+        size_t size;            /**< Tamaño nominal. */
+        uint8_t *rle;           /**< Flujo RLE válido. */
+        uint8_t *lz78;          /**< Flujo LZ78 válido. */
+        uint8_t *rle_enc;       /**< Flujo RLE cifrado con (BENCH_N, BENCH_K). */
+        char *text;             /**< Texto terminado en NUL (salida de `rle`). */
+        size_t text_len;        /**< Longitud de `text`. */
+        char frag[16];          /**< Fragmento tomado del final de `text`. */
+        hint_matcher_t hm;      /**< Buscador preparado para `frag`. */
+        uint8_t *scratch;       /**< Buffer de destino para los kernels in-place. */
+    } bench_input_t;
+
+    /**
+     * @brief Generador pseudoaleatorio rápido y reproducible (xorshift64).
+     */
+    uint64_t next_rand(uint64_t *state)
+    {
+        uint64_t x = *state;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        *state = x;
+        return x;
+    }
+
+    /**
+     * @brief Flujo RLE de @p len bytes: corridas cortas de letras minúsculas.
+     */
+    uint8_t *gen_rle(size_t len, uint64_t seed)
+    {
+        uint8_t *buf = new uint8_t[len];
+        size_t i = 0;
+        for (; i + 2 < len; i += 3)
+        {
+            uint64_t r = next_rand(&seed);
+            buf[i] = 0;
+            buf[i + 1] = (uint8_t)(1 + r % 8);
+            buf[i + 2] = (uint8_t)('a' + (r >> 8) % 26);
+        }
+        for (; i < len; i++)
+        {
+            buf[i] = 0;
+        }
+        return buf;
+    }
+
+    /**
+     * @brief Flujo LZ78 válido de @p len bytes con índices aleatorios a entradas existentes.
+     */
+    uint8_t *gen_lz78(size_t len, uint64_t seed)
+    {
+        uint8_t *buf = new uint8_t[len];
+        size_t i = 0;
+        for (size_t t = 0; i + 2 < len; i += 3, t++)
+        {
+            uint64_t r = next_rand(&seed);
+            size_t max_idx = t < LZ78_MAX_INDEX ? t : LZ78_MAX_INDEX;
+            size_t idx = (r & 3) == 0 ? 0 : (size_t)((r >> 2) % (max_idx + 1));
+            buf[i] = (uint8_t)(idx >> 8);
+            buf[i + 1] = (uint8_t)(idx & 0xFF);
+            buf[i + 2] = (uint8_t)('a' + (r >> 24) % 26);
+        }
+        for (; i < len; i++)
+        {
+            buf[i] = 0;
+        }
+        return buf;
+    }
+
+    void input_init(bench_input_t *in, size_t size)
+    {
+        in->size = size;
+        in->rle = gen_rle(size, 0x9E3779B97F4A7C15ULL ^ size);
+        in->lz78 = gen_lz78(size, 0xD1B54A32D192ED03ULL ^ size);
+        in->rle_enc = encrypt_buffer(in->rle, size, BENCH_N, BENCH_K);
+        in->text = rle_decompress(in->rle, size);
+        in->scratch = new uint8_t[size];
+
+        // Fragmento tomado del final: obliga a recorrer todo el texto
+        size_t tlen = strlen(in->text);
+        size_t flen = tlen < 8 ? tlen : 8;
+        memcpy(in->frag, in->text + tlen - flen, flen);
+        in->frag[flen] = '\0';
+        in->text_len = tlen;
+        matcher_init(&in->hm, in->frag);
+    }
+
+    void input_free(bench_input_t *in)
+    {
+        delete[] in->rle;
+        delete[] in->lz78;
+        delete[] in->rle_enc;
+        delete[] in->text;
+        delete[] in->scratch;
+        matcher_free(&in->hm);
+    }
+
+    /**
+     * @brief Búsqueda secuencial de @p part dentro de @p text (distingue mayúsculas).
+     *
+     * Es la búsqueda que usaba el solver antes de `matcher_find()`; se conserva solo como
+     * referencia para comparar su rendimiento.
+     */
+    bool contains_substr(const char *text, const char *part)
+    {
+        size_t text_len = strlen(text);
+        size_t part_len = strlen(part);
+
+        for (size_t i = 0; i + part_len <= text_len; i++)
+        {
+            size_t k = 0;
+            while (k < part_len && text[i + k] == part[k])
+            {
+                k++;
+            }
+            if (k == part_len)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ====== Kernels medidos ============
+    // Cada uno procesa la entrada completa una vez y devuelve un valor para evitar
+    // que el compilador elimine el trabajo.
+
+    size_t k_decrypt_buffer(bench_input_t *in)
+    {
+        uint8_t *dec = decrypt_buffer(in->rle_enc, in->size, BENCH_N, BENCH_K);
+        size_t r = dec[0];
+        delete[] dec;
+        return r;
+    }
+
+    size_t k_printable_ratio(bench_input_t *in)
+    {
+        uint16_t cands[N_CANDIDATES];
+        return prefilter_candidates(in->rle_enc, in->size, cands);
+    }
+
+    size_t k_contains_substr(bench_input_t *in)
+    {
+        return contains_substr(in->text, in->frag);
+    }
+
+    size_t k_matcher_find(bench_input_t *in)
+    {
+        return matcher_find(&in->hm, in->text, in->text_len);
+    }
+
+    size_t k_matcher_feed(bench_input_t *in)
+    {
+        uint32_t state = 0;
+        return matcher_feed(&in->hm, &state, in->text, in->text_len);
+    }
+
+    size_t k_rle(bench_input_t *in)
+    {
+        char *out = rle_decompress(in->rle, in->size);
+        size_t r = (size_t)out[0];
+        delete[] out;
+        return r;
+    }
+
+    size_t k_rle_parallel(bench_input_t *in)
+    {
+        char *out = rle_decompress_parallel(in->rle, in->size, 0);
+        size_t r = (size_t)out[0];
+        delete[] out;
+        return r;
+    }
+
+    size_t k_lz78(bench_input_t *in)
+    {
+        char *out = lz78_decompress(in->lz78, in->size);
+        size_t r = out ? (size_t)out[0] : 0;
+        delete[] out;
+        return r;
+    }
+
+    size_t k_lz78_parallel(bench_input_t *in)
+    {
+        char *out = lz78_decompress_parallel(in->lz78, in->size, 0);
+        size_t r = out ? (size_t)out[0] : 0;
+        delete[] out;
+        return r;
+    }
+
+    /**
+     * @brief Ejecuta una función de búsqueda y libera sus salidas.
+     */
+    template <typename F>
+    size_t run_finder(F find)
+    {
+        char *msg = nullptr;
+        char *method = nullptr;
+        uint8_t n = 0, k = 0;
+        bool ok = find(&msg, &method, &n, &k);
+        if (ok)
+        {
+            delete[] msg;
+            delete[] method;
+        }
+        return ok ? (size_t)n * 256 + k : 0;
+    }
+
+    size_t k_finder(bench_input_t *in)
+    {
+        return run_finder([&](char **m, char **me, uint8_t *n, uint8_t *k)
+                          { return finder(in->rle_enc, in->size, in->frag, m, me, n, k); });
+    }
+
+    size_t k_finder_parallel(bench_input_t *in)
+    {
+        return run_finder([&](char **m, char **me, uint8_t *n, uint8_t *k)
+                          { return finder_parallel(in->rle_enc, in->size, in->frag, m, me, n, k, 0); });
+    }
+
+    size_t k_finder_kpa(bench_input_t *in)
+    {
+        return run_finder([&](char **m, char **me, uint8_t *n, uint8_t *k)
+                          { return finder_known_plaintext(in->rle_enc, in->size, in->frag, m, me, n, k); });
+    }
+
+    /**
+     * @struct bench_kernel_t
+     * @brief Kernel a medir.
+     */
+    typedef struct {
+        const char *name;                   /**< Nombre en la tabla. */
+        size_t (*fn)(bench_input_t *);      /**< Kernel. */
+        size_t candidates;                  /**< Candidatos (n, k) por llamada (0 = no aplica). */
+    } bench_kernel_t;
+
+    const bench_kernel_t KERNELS[] = {
+        {"decrypt_buffer", k_decrypt_buffer, 1},
+        {"printable_ratio", k_printable_ratio, N_CANDIDATES},
+        {"contains_substr", k_contains_substr, 0},
+        {"matcher_find", k_matcher_find, 0},
+        {"matcher_feed", k_matcher_feed, 0},
+        {"rle_decompress", k_rle, 0},
+        {"rle_decompress_parallel", k_rle_parallel, 0},
+        {"lz78_decompress", k_lz78, 0},
+        {"lz78_decompress_parallel", k_lz78_parallel, 0},
+        {"finder", k_finder, N_CANDIDATES},
+        {"finder_parallel", k_finder_parallel, N_CANDIDATES},
+        {"finder_known_plaintext", k_finder_kpa, N_CANDIDATES},
+    };
+
+    /**
+     * @brief Mide un kernel repitiéndolo hasta acumular @p min_time segundos.
+     */
+    void measure(const bench_kernel_t *kern, bench_input_t *in, double min_time)
+    {
+        volatile size_t sink = 0;
+        size_t iters = 0;
+        size_t allocs = 0;
+        double elapsed = 0;
+
+        while (iters == 0 || (elapsed < min_time && iters < 1000))
+        {
+            size_t a0 = g_allocs.load();
+            auto t0 = chrono::steady_clock::now();
+            sink = sink + kern->fn(in);
+            elapsed += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            allocs += g_allocs.load() - a0;
+            iters++;
+        }
+
+        double per_call = elapsed / (double)iters;
+        double mbps = (double)in->size / per_call / 1e6;
+
+        char per_cand[32] = "-";
+        if (kern->candidates)
+        {
+            snprintf(per_cand, sizeof(per_cand), "%.3f", per_call * 1e6 / (double)kern->candidates);
+        }
+
+        printf("%-26s %12zu %12.1f %14.3f %14s %12.1f\n", kern->name, in->size, mbps,
+               per_call * 1e6, per_cand, (double)allocs / (double)iters);
+        fflush(stdout);
+    }
+
+    /**
+     * @brief Compara @p len bytes de dos buffers e informa la primera diferencia.
+     */
+    bool same_bytes(const uint8_t *ref, const uint8_t *got, size_t len, const char *what,
+                    kernel_isa_t isa, uint8_t n, uint8_t k, size_t off)
+    {
+        if (memcmp(ref, got, len) == 0)
+        {
+            return true;
+        }
+        size_t i = 0;
+        while (ref[i] == got[i])
+        {
+            i++;
+        }
+        printf("DIFERENCIA %s [%s] n=%u k=0x%02X desplazamiento=%zu largo=%zu byte=%zu: %02X != %02X\n",
+               what, kernels_isa_name(isa), (unsigned)n, (unsigned)k, off, len, i, ref[i], got[i]);
+        return false;
+    }
+
+    /**
+     * @brief Verifica que todas las versiones de los kernels den los mismos bytes que la escalar.
+     *
+     * @return `true` si no hubo diferencias.
+     */
+    bool verify_kernels()
+    {
+        kernel_isa_t original = kernels_active_isa();
+
+        uint8_t *in = new uint8_t[VERIFY_SIZE];
+        uint8_t *ref = new uint8_t[VERIFY_SIZE];
+        uint8_t *got = new uint8_t[VERIFY_SIZE];
+        uint64_t seed = 0x243F6A8885A308D3ULL;
+        for (size_t i = 0; i < VERIFY_SIZE; i++)
+        {
+            in[i] = (uint8_t)next_rand(&seed);
+        }
+
+        // Desplazamientos y longitudes que dejan el inicio y la cola fuera de un vector
+        const size_t offsets[] = {0, 1, 7, 33};
+        const size_t lens[] = {0, 1, 15, 31, 63, 65, 4093, VERIFY_SIZE - 64};
+        const uint8_t keys[] = {0x00, 0x5A, 0x80, 0xFF};
+        const kernel_isa_t isas[] = {ISA_SSE2, ISA_AVX2, ISA_AVX512};
+
+        bool ok = true;
+        size_t checked = 0;
+        for (kernel_isa_t isa : isas)
+        {
+            if (!kernels_force_isa(isa))
+            {
+                printf("%-8s no disponible\n", kernels_isa_name(isa));
+                continue;
+            }
+
+            for (uint8_t n = 0; n < 8 && ok; n++)
+            {
+                for (uint8_t k : keys)
+                {
+                    for (size_t off : offsets)
+                    {
+                        for (size_t len : lens)
+                        {
+                            kernels_force_isa(ISA_SCALAR);
+                            decrypt_into(in + off, ref, len, n, k);
+                            kernels_force_isa(isa);
+                            decrypt_into(in + off, got, len, n, k);
+                            ok = ok && same_bytes(ref, got, len, "decrypt_into", isa, n, k, off);
+
+                            // En el mismo buffer (out == in)
+                            memcpy(got, in + off, len);
+                            decrypt_into(got, got, len, n, k);
+                            ok = ok && same_bytes(ref, got, len, "decrypt_into (in-place)", isa, n, k, off);
+                            checked += 2;
+                        }
+                    }
+                }
+
+                // Claves de varios bytes: todas las longitudes hasta KEY_LEN_MAX
+                for (size_t key_len = 1; key_len <= KEY_LEN_MAX && ok; key_len++)
+                {
+                    uint8_t key[KEY_LEN_MAX];
+                    for (size_t i = 0; i < key_len; i++)
+                    {
+                        key[i] = (uint8_t)next_rand(&seed);
+                    }
+                    size_t len = VERIFY_SIZE - 1 - key_len;
+                    kernels_force_isa(ISA_SCALAR);
+                    decrypt_into_key(in + 1, ref, len, n, key, key_len);
+                    kernels_force_isa(isa);
+                    decrypt_into_key(in + 1, got, len, n, key, key_len);
+                    ok = ok && same_bytes(ref, got, len, "decrypt_into_key", isa, n, key[0], 1);
+                    checked++;
+                }
+            }
+            printf("%-8s %s\n", kernels_isa_name(isa), ok ? "igual a la escalar" : "DIFIERE");
+            if (!ok)
+            {
+                break;
+            }
+        }
+
+        kernels_force_isa(original);
+        delete[] in;
+        delete[] ref;
+        delete[] got;
+        printf("%zu comparaciones sobre %zu bytes aleatorios: %s\n", checked, VERIFY_SIZE, ok ? "OK" : "ERROR");
+        return ok;
+    }
+
+    /**
+     * @brief Interpreta un tamaño con sufijo opcional K, M o G (potencias de 1024).
+     */
+    size_t parse_size(const char *s)
+    {
+        char *end = nullptr;
+        double v = strtod(s, &end);
+        switch (*end)
+        {
+        case 'k': case 'K': v *= 1024.0; break;
+        case 'm': case 'M': v *= 1024.0 * 1024.0; break;
+        case 'g': case 'G': v *= 1024.0 * 1024.0 * 1024.0; break;
+        default: break;
+        }
+        return (size_t)v;
+    }
+
+}
+
+int main(int argc, char *argv[])
+{
+    bench_opts_t opts = {1024, (size_t)1024 * 1024 * 1024, nullptr, 0.2};
+
+    if (argc > 1 && strcmp(argv[1], "--verify") == 0)
+    {
+        return verify_kernels() ? 0 : 1;
+    }
+
+    for (int a = 1; a + 1 < argc; a += 2)
+    {
+        if (strcmp(argv[a], "--min") == 0)
+        {
+            opts.min_size = parse_size(argv[a + 1]);
+        }
+        else if (strcmp(argv[a], "--max") == 0)
+        {
+            opts.max_size = parse_size(argv[a + 1]);
+        }
+        else if (strcmp(argv[a], "--only") == 0)
+        {
+            opts.only = argv[a + 1];
+        }
+        else if (strcmp(argv[a], "--time") == 0)
+        {
+            opts.min_time = atof(argv[a + 1]);
+        }
+    }
+
+    printf("ISA: %s, hilos: %u\n", kernels_isa_name(kernels_active_isa()), thread::hardware_concurrency());
+    printf("%-26s %12s %12s %14s %14s %12s\n", "kernel", "bytes", "MB/s", "us/llamada", "us/candidato", "allocs");
+
+    for (size_t size = opts.min_size; size <= opts.max_size; size *= 4)
+    {
+        bench_input_t in;
+        input_init(&in, size);
+
+        for (const bench_kernel_t &kern : KERNELS)
+        {
+            if (opts.only && !strstr(kern.name, opts.only))
+            {
+                continue;
+            }
+            measure(&kern, &in, opts.min_time);
+        }
+
+        input_free(&in);
+    }
+
+    return 0;
+}
@@ -0,0 +1,29 @@
+# Microbenchmarks de los kernels (no usa Qt)
+CONFIG  += c++17 console
+CONFIG  -= qt app_bundle
+
+SOURCES += \
+    bench.cpp \
+    ../src/solver.cpp \
+    ../src/compress.cpp \
+    ../src/kernels.cpp \
+    ../src/trace.cpp \
+    ../src/matcher.cpp
+
+HEADERS += \
+    ../include/solver.hpp \
+    ../include/solver_internal.hpp \
+    ../include/compress.hpp \
+    ../include/kernels.hpp \
+    ../include/trace.hpp \
+    ../include/matcher.hpp
+
+INCLUDEPATH += ../include
+
+trace: DEFINES += DESAFIO_TRACE
+
+# Carpetas de salida
+DESTDIR     = bin        # ejecutable
+OBJECTS_DIR = build      # objetos intermedios (.o)
+
+TARGET = Desafio_1_bench
@@ -21,9 +21,15 @@
 
 #include <compress.hpp>
 #include <solver.hpp>
+#include <input.hpp>
 
 #define NO_SIZE 0
 
+// Modo interactivo: hilos que leen los pares por adelantado y pares leídos de más por
+// encima de los que se están resolviendo
+#define APP_READERS 2
+#define APP_PREFETCH_DEPTH 4
+
 /**
  * @enum my_error_t
  * @brief Enumeración para el manejo de errores y excepciones.
@@ -43,12 +49,39 @@ using namespace std;
  * @brief Punto de entrada principal de la aplicación.
  *
  * Contiene la lógica y el flujo de la aplicación, ejecutando
- * los módulos principales.
+ * los módulos principales. Sin argumentos pregunta por la cantidad de
+ * archivos (modo interactivo); con `--stream` delega en `stream_main()`, con
+ * `--daemon` en `daemon_main()` y con cualquier otro argumento en `batch_main()`.
+ *
+ * El modo interactivo es un pipeline de tres etapas: APP_READERS hilos abren y leen los
+ * pares siguientes, un grupo de trabajadores los resuelve y el hilo principal imprime los
+ * resultados en el orden de los archivos. Así el disco lee mientras la CPU busca y el tiempo
+ * total se acerca al mayor de los dos en lugar de su suma.
+ *
+ * @param argc Cantidad de argumentos de `main`.
+ * @param argv Argumentos de `main`.
  *
  * @return OK si la ejecución fue exitosa.
  * @return ERROR si ocurrió un error durante la ejecución.
  */
-my_error_t app_main();
+my_error_t app_main(int argc, char **argv);
+
+/**
+ * @brief Modo por bloques para archivos que no caben en memoria.
+ *
+ * Resuelve un único par con `finder_stream()` y escribe el mensaje en un archivo:
+ *
+ * @code{.txt}
+ * ./Desafio_1 --stream Encriptado1.txt --hint pista1.txt -o mensaje1.txt [--mem 64M]
+ * @endcode
+ *
+ * @param argc Cantidad de argumentos de `main`.
+ * @param argv Argumentos de `main`.
+ *
+ * @return OK si se encontró la combinación y se escribió el mensaje.
+ * @return ERROR si faltan opciones, no se pudo leer o no hubo coincidencia.
+ */
+my_error_t stream_main(int argc, char **argv);
 
 /**
  * @brief Lee el contenido de un archivo de texto.
@@ -57,6 +90,9 @@ my_error_t app_main();
  * un buffer dinámico. La memoria debe ser liberada por el
  * llamador.
  *
+ * @note Hace una copia del archivo; para entradas grandes es preferible
+ *       `input_open()`, que entrega una vista mapeada sin copias.
+ *
  * @param[in] path Ruta al archivo de entrada.
  * @param[out] out_buf Doble puntero donde se almacenará el buffer leído.
  * @param[out] out_len Tamaño total en bytes del contenido leído.
@@ -76,6 +112,8 @@ my_error_t read_file(const char* path, uint8_t** out_buf, size_t* out_len);
  *
  * @return Puntero a una cadena de caracteres con el fragmento extraído.
  *         El llamador es responsable de liberar la memoria reservada.
+ *
+ * @note Hace una copia; `input_open_text()` entrega la pista sin copiarla.
  */
 char* get_frag(const char* path);
 
@@ -0,0 +1,64 @@
+/**
+ * @file batch.hpp
+ * @brief Archivo de cabecera para el modo por lotes (no interactivo)
+ *
+ * Este modulo contiene:
+ * batch_main: Resuelve muchos pares (encriptado, pista) en paralelo desde la línea de comandos
+ *
+ * Los pares se obtienen de una carpeta, de un manifiesto o de un patrón glob y se reparten
+ * entre un grupo de hilos. Cada resultado se escribe como una línea JSON:
+ *
+ * @code{.txt}
+ * {"enc":"in/Encriptado1.txt","hint":"in/pista1.txt","found":true,"n":3,"k":90,"method":"RLE","len":1034,"ms":0.412}
+ * @endcode
+ *
+ * Si el par se resolvió con una clave de varios bytes (`finder_multikey()`), `"k"` se
+ * reemplaza por `"key"` con la clave en hexadecimal.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <app.hpp>
+#include <keycache.hpp>
+
+// Eventos que se guardan como máximo para `--trace`
+#define TRACE_MAX_EVENTS (1 << 22)
+
+/**
+ * @brief Punto de entrada del modo por lotes.
+ *
+ * Opciones:
+ *  - `--dir <carpeta>`: usa cada `EncriptadoN.txt` de la carpeta con su `pistaN.txt`.
+ *  - `--manifest <archivo>`: una línea por par, `<encriptado> <pista>` (las líneas con `#` se ignoran).
+ *  - `--glob <patrón>`: archivos encriptados que cumplen el patrón (`*` y `?` en el nombre);
+ *    la pista se obtiene cambiando `Encriptado` por `pista` en el nombre.
+ *  - `-j <hilos>`: tamaño del grupo de hilos (0 o sin indicar: todos los núcleos). Con
+ *    menos pares que hilos, los que sobran se reparten en la fuerza bruta de cada par.
+ *  - `-o <archivo>`: destino de las líneas JSON (por defecto, la salida estándar).
+ *  - `--out-dir <carpeta>`: guarda cada mensaje en su archivo (`mensajeN.txt`). Si dos
+ *    encriptados darían el mismo nombre (p. ej. `a/Encriptado1.txt` y `b/Encriptado1.txt`),
+ *    no se procesa ningún par.
+ *  - `--archive <archivo>`: guarda todos los mensajes en un archivo con índice `<archivo>.idx`
+ *    (ver output.hpp). Sin ninguna de las dos, los mensajes no se guardan.
+ *  - `--cache <archivo>`: caché de claves (por defecto `keycache_default_path()`);
+ *    `none` la deja solo en memoria.
+ *  - `--trace <archivo>`: exporta los eventos por etapa en formato Chrome trace-event
+ *    (solo si se compiló con `CONFIG+=trace`).
+ *
+ * @param argc Cantidad de argumentos de `main`.
+ * @param argv Argumentos de `main`.
+ *
+ * @return OK si se procesaron los pares (aunque algunos no se resolvieran).
+ * @return ERROR si las opciones son inválidas, no hay pares para procesar o no se pudo
+ *         guardar algún mensaje (su línea JSON lleva `"error"`).
+ */
+my_error_t batch_main(int argc, char **argv);
+
+#endif // BATCH_HPP
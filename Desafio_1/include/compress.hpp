@@ -6,7 +6,14 @@
  * ror_8: Rotación de bits a la derecha
  * rol_8: Rotación de bits a la izquierda
  * rle_decompress: Función para la descompresión por medio de RLE
+ * rle_decompress_parallel: Expansión RLE de tamaño exacto repartida entre hilos
  * LZ78_decompress: Función para la descompresión por medio de LZ78
+ * lz78_decompress_parallel: Descompresión LZ78 en dos pasadas repartida entre hilos
+ * rle_stream_* / lz78_stream_*: Decodificadores incrementales que entregan la salida por bloques
+ * rle_compress / lz78_compress: Compresores (generación de corpus de prueba)
+ * classify_stream: Validación estructural de un flujo antes de descomprimirlo
+ * classifier_*: La misma validación sobre un flujo que llega por bloques
+ * rle_decode / lz78_decode: API por buffers (span de entrada, sink de salida, estado y longitud explícitos)
  *
  * @authors Julián Sánchez
  *          Jaider Bedoya
@@ -22,6 +29,7 @@
 #include <cstdint>
 #include <cctype>
 #include <cstring>
+#include <thread>
 
 using namespace std;
 
@@ -64,12 +72,46 @@ uint8_t rol_8 (uint8_t v, unsigned int n);
  * }
  * @endcode
  * 
+ * @note La salida se reserva una sola vez con su tamaño exacto (suma de las repeticiones)
+ * y cada corrida se escribe con `memset`, sin copias por redimensionamiento.
+ *
  * @note Gracias al estándar intergaláctico de compresión inventado en este curso, 
  * debemos leer de a 3 bytes aunque uno sea pura basura y rompa el estandar de la compresión. 
  * #InnovaciónPedagógica
  */
 char *rle_decompress(const uint8_t *in, size_t len);
 
+// Por debajo de esta cantidad de triples no vale la pena repartir la expansión RLE
+#define RLE_PARALLEL_MIN (1 << 20)
+
+/**
+ * @brief   Versión paralela de `rle_decompress()` para entradas grandes.
+ *
+ * Reparte los triples entre @p n_threads hilos: cada uno suma las repeticiones de su
+ * bloque, una suma prefija da la posición de salida de cada bloque y luego cada hilo
+ * expande sus corridas en su región con `memset`. La salida se reserva una sola vez.
+ *
+ * @param   in         Puntero a los datos comprimidos.
+ * @param   len        Longitud de la entrada en bytes.
+ * @param   n_threads  Número de hilos; 0 usa `thread::hardware_concurrency()`.
+ *
+ * @return  La misma salida que `rle_decompress()` (liberar con `delete[]`). Con menos de
+ *          RLE_PARALLEL_MIN triples o un solo hilo delega en `rle_decompress()`.
+ */
+char *rle_decompress_parallel(const uint8_t *in, size_t len, unsigned int n_threads);
+
+
+// LZ78 usa índices de 16 bits: solo las primeras LZ78_MAX_INDEX entradas son referenciables
+#define LZ78_MAX_INDEX 65535
+
+/**
+ * @struct lz78_ref_t
+ * @brief Entrada del diccionario LZ78 como referencia a una frase ya escrita en la salida.
+ */
+typedef struct {
+    size_t off;     /**< Posición de la frase en el buffer de salida. */
+    size_t len;     /**< Longitud de la frase. */
+} lz78_ref_t;
 
 /**
  * @brief   Descomprime datos usando el algoritmo LZ78.
@@ -84,6 +126,11 @@ char *rle_decompress(const uint8_t *in, size_t len);
  * @note    La función asigna memoria dinámica para la salida y para el diccionario.
  *          En caso de error, se libera toda la memoria reservada.
  *
+ * @note    El diccionario es un único arreglo de referencias (offset, longitud) a frases
+ *          ya escritas en la salida (ver @ref lz78_ref_t), reservado una sola vez. Decodificar
+ *          un token es una copia acotada, sin reservas por entrada, y la memoria crece de
+ *          forma lineal con la salida.
+ *
  * Ejemplo de uso:
  * @code
  * const uint8_t data[] = "0A1B2C";
@@ -96,6 +143,388 @@ char *rle_decompress(const uint8_t *in, size_t len);
  */
 char *lz78_decompress(const uint8_t *in, size_t len);
 
+/**
+ * @brief   Versión paralela de `lz78_decompress()` para entradas muy grandes.
+ *
+ * La longitud de cada frase es la del padre más uno, y un índice de 16 bits solo puede
+ * referenciar frases creadas por los primeros LZ78_MAX_INDEX tokens. Por eso:
+ *  1. El prefijo de LZ78_MAX_INDEX tokens se valida y se decodifica en serie.
+ *  2. Una pasada paralela suma los bytes de salida de cada bloque de tokens y una suma
+ *     prefija da la posición exacta de cada bloque (la salida se reserva una sola vez).
+ *  3. Una segunda pasada paralela copia cada frase desde la posición de su padre.
+ *
+ * @param   in         Puntero al arreglo de bytes comprimidos.
+ * @param   len        Longitud de la entrada en bytes.
+ * @param   n_threads  Número de hilos; 0 usa `thread::hardware_concurrency()`.
+ *
+ * @return  La misma cadena, byte a byte, que devolvería `lz78_decompress()` (liberar con
+ *          `delete[]`), o nullptr si la entrada es inválida. Con pocos tokens o un solo
+ *          hilo delega en `lz78_decompress()`.
+ */
+char *lz78_decompress_parallel(const uint8_t *in, size_t len, unsigned int n_threads);
+
+
+// ====== Decodificadores incrementales ============
+
+// Tamaño del bloque de salida que los decodificadores entregan al sink
+#define STREAM_CHUNK 4096
+
+/**
+ * @brief Función que recibe cada bloque de salida de un decodificador incremental.
+ *
+ * @param chunk  Bytes descomprimidos (no terminados en NUL).
+ * @param len    Cantidad de bytes del bloque.
+ * @param user   Puntero de contexto entregado al decodificador.
+ *
+ * @return `true` para seguir decodificando, `false` para detener el decodificador.
+ */
+typedef bool (*chunk_sink_t)(const char *chunk, size_t len, void *user);
+
+/**
+ * @enum stream_status_t
+ * @brief Estado que devuelve un decodificador incremental después de cada entrada.
+ */
+typedef enum {
+    STREAM_MORE,    /**< Se consumió toda la entrada; puede recibir más. */
+    STREAM_STOP,    /**< El sink pidió detener la decodificación. */
+    STREAM_INVALID  /**< La entrada no es un flujo válido para el formato. */
+} stream_status_t;
+
+/**
+ * @struct rle_stream_t
+ * @brief Estado de un decodificador RLE incremental.
+ *
+ * Guarda el triple incompleto entre llamadas, por lo que la entrada puede llegar
+ * partida en cualquier posición.
+ */
+typedef struct {
+    uint8_t pending[3];          /**< Bytes de un triple aún incompleto. */
+    size_t n_pending;            /**< Cantidad de bytes en @ref pending. */
+    size_t out_len;              /**< Bytes emitidos hasta ahora. */
+    size_t chunk_len;            /**< Bytes acumulados en @ref chunk. */
+    char chunk[STREAM_CHUNK];    /**< Bloque de salida pendiente de entregar. */
+} rle_stream_t;
+
+/**
+ * @struct lz78_entry_t
+ * @brief Entrada del diccionario LZ78 como nodo de un trie: frase del padre + un símbolo.
+ */
+typedef struct {
+    uint32_t len;       /**< Longitud de la frase. */
+    uint16_t parent;    /**< Índice de la frase padre (0 = frase vacía). */
+    char sym;           /**< Símbolo agregado al padre. */
+} lz78_entry_t;
+
+/**
+ * @struct lz78_stream_t
+ * @brief Estado de un decodificador LZ78 incremental.
+ *
+ * El diccionario se guarda como un trie de punteros al padre y solo se almacenan las
+ * LZ78_MAX_INDEX entradas que un índice de 16 bits puede referenciar, así que la memoria
+ * es constante sin importar el tamaño de la salida. Cada frase se reconstruye recorriendo
+ * la cadena de padres.
+ */
+typedef struct {
+    lz78_entry_t *dict;     /**< Entradas 1..LZ78_MAX_INDEX (la 0 es la frase vacía). */
+    size_t dict_count;      /**< Tokens decodificados (todos crean una entrada). */
+    uint8_t pending[3];     /**< Bytes de un triple aún incompleto. */
+    size_t n_pending;       /**< Cantidad de bytes en @ref pending. */
+    size_t out_len;         /**< Bytes emitidos hasta ahora. */
+    char *chunk;            /**< Bloque de salida (cabe al menos una frase completa). */
+    size_t chunk_len;       /**< Bytes acumulados en @ref chunk. */
+    bool keep_nul;          /**< Escribir los símbolos NUL (false: se descartan, como `lz78_decompress()`). */
+} lz78_stream_t;
+
+/**
+ * @brief Inicializa un decodificador RLE incremental.
+ */
+void rle_stream_init(rle_stream_t *s);
+
+/**
+ * @brief Decodifica @p len bytes más de un flujo RLE, entregando la salida por bloques a @p sink.
+ *
+ * @param s     Estado del decodificador.
+ * @param in    Siguiente porción del flujo comprimido.
+ * @param len   Longitud de la porción.
+ * @param sink  Receptor de los bloques de salida.
+ * @param user  Contexto para @p sink.
+ *
+ * @return STREAM_MORE si se consumió la porción, STREAM_STOP si @p sink pidió detenerse.
+ */
+stream_status_t rle_stream_feed(rle_stream_t *s, const uint8_t *in, size_t len, chunk_sink_t sink, void *user);
+
+/**
+ * @brief Entrega a @p sink la salida que aún esté acumulada (llamar al terminar la entrada).
+ *
+ * @return STREAM_MORE, o STREAM_STOP si @p sink pidió detenerse.
+ */
+stream_status_t rle_stream_finish(rle_stream_t *s, chunk_sink_t sink, void *user);
+
+/**
+ * @brief Inicializa un decodificador LZ78 incremental (reserva el diccionario y el bloque de salida).
+ *
+ * Empieza con `keep_nul` en false (los símbolos NUL se descartan, como en
+ * `lz78_decompress()`). Debe liberarse con `lz78_stream_free()`.
+ */
+void lz78_stream_init(lz78_stream_t *s);
+
+/**
+ * @brief Reinicia un decodificador LZ78 incremental para un flujo nuevo, sin volver a reservar memoria.
+ */
+void lz78_stream_reset(lz78_stream_t *s);
+
+/**
+ * @brief Libera la memoria de un decodificador LZ78 incremental.
+ */
+void lz78_stream_free(lz78_stream_t *s);
+
+/**
+ * @brief Decodifica @p len bytes más de un flujo LZ78, entregando la salida por bloques a @p sink.
+ *
+ * El estado del diccionario se conserva entre llamadas.
+ *
+ * @return STREAM_MORE si se consumió la porción, STREAM_STOP si @p sink pidió detenerse,
+ *         STREAM_INVALID si algún token referencia una entrada inexistente.
+ */
+stream_status_t lz78_stream_feed(lz78_stream_t *s, const uint8_t *in, size_t len, chunk_sink_t sink, void *user);
+
+/**
+ * @brief Entrega a @p sink la salida que aún esté acumulada (llamar al terminar la entrada).
+ *
+ * @return STREAM_MORE, o STREAM_STOP si @p sink pidió detenerse.
+ */
+stream_status_t lz78_stream_finish(lz78_stream_t *s, chunk_sink_t sink, void *user);
+
+
+
+// ====== API por buffers ============
+
+/**
+ * @struct byte_span_t
+ * @brief Vista de solo lectura a un rango de bytes (no es dueña de la memoria).
+ */
+typedef struct {
+    const uint8_t *data;    /**< Primer byte. */
+    size_t len;             /**< Cantidad de bytes. */
+} byte_span_t;
+
+/**
+ * @enum decode_status_t
+ * @brief Resultado de `rle_decode()` / `lz78_decode()`.
+ */
+typedef enum {
+    DECODE_OK,          /**< Se decodificó el flujo completo. */
+    DECODE_INVALID,     /**< El flujo no es válido (índice LZ78 a una entrada inexistente). */
+    DECODE_NO_SPACE,    /**< El buffer fijo se llenó. RLE lo llena hasta su capacidad; LZ78 se
+                             detiene en la última frase completa que cupo. En ambos casos el
+                             buffer contiene un prefijo exacto de la salida de `*out_len` bytes. */
+    DECODE_STOPPED      /**< El callback pidió detener la decodificación. */
+} decode_status_t;
+
+/**
+ * @struct growable_buffer_t
+ * @brief Buffer de salida que crece según haga falta y se libera solo (RAII).
+ *
+ * Se puede reutilizar entre llamadas con `clear()`, que conserva la capacidad.
+ */
+struct growable_buffer_t
+{
+    char *data = nullptr;   /**< Contenido (no terminado en NUL). */
+    size_t len = 0;         /**< Bytes válidos. */
+    size_t cap = 0;         /**< Capacidad reservada. */
+
+    growable_buffer_t() = default;
+    ~growable_buffer_t() { delete[] data; }
+    growable_buffer_t(const growable_buffer_t &) = delete;
+    growable_buffer_t &operator=(const growable_buffer_t &) = delete;
+
+    /** Vacía el buffer sin liberar la memoria. */
+    void clear() { len = 0; }
+
+    /** Entrega la memoria al llamador (liberar con `delete[]`) y deja el buffer vacío. */
+    char *release()
+    {
+        char *p = data;
+        data = nullptr;
+        len = 0;
+        cap = 0;
+        return p;
+    }
+};
+
+/**
+ * @enum sink_kind_t
+ * @brief Tipos de destino de la API por buffers.
+ */
+typedef enum {
+    SINK_FIXED,     /**< Buffer del llamador de tamaño fijo. */
+    SINK_GROWABLE,  /**< `growable_buffer_t` que crece según haga falta. */
+    SINK_CALLBACK   /**< Función que recibe la salida en bloques de tamaño variable: RLE hasta
+                         STREAM_CHUNK bytes, LZ78 hasta STREAM_CHUNK + LZ78_MAX_INDEX + 1
+                         (nunca corta una frase). */
+} sink_kind_t;
+
+/**
+ * @struct decode_sink_t
+ * @brief Destino de la salida de `rle_decode()` / `lz78_decode()`.
+ *
+ * Se construye con `sink_fixed()`, `sink_growable()` o `sink_callback()`.
+ */
+typedef struct {
+    sink_kind_t kind;           /**< Tipo de destino. */
+    char *buf;                  /**< SINK_FIXED: buffer del llamador. */
+    size_t cap;                 /**< SINK_FIXED: capacidad del buffer. */
+    growable_buffer_t *grow;    /**< SINK_GROWABLE: buffer que recibe la salida (se agrega al final). */
+    chunk_sink_t fn;            /**< SINK_CALLBACK: función receptora. */
+    void *user;                 /**< SINK_CALLBACK: contexto de @ref fn. */
+} decode_sink_t;
+
+/** @brief Destino en un buffer fijo de @p cap bytes. */
+decode_sink_t sink_fixed(char *buf, size_t cap);
+
+/** @brief Destino en un buffer que crece; la salida se agrega a lo que ya tenga. */
+decode_sink_t sink_growable(growable_buffer_t *buf);
+
+/** @brief Destino por bloques: @p fn recibe la salida a medida que se produce. */
+decode_sink_t sink_callback(chunk_sink_t fn, void *user);
+
+/**
+ * @brief   Tamaño exacto de la salida de un flujo RLE (suma de las repeticiones).
+ *
+ * Sirve para reservar un buffer fijo justo antes de `rle_decode()`.
+ */
+size_t rle_decoded_size(byte_span_t in);
+
+/**
+ * @brief   Decodifica un flujo RLE completo hacia @p out.
+ *
+ * A diferencia de `rle_decompress()`, la salida no depende de un terminador: los símbolos
+ * NUL se escriben como cualquier otro byte y la longitud se informa en @p out_len.
+ *
+ * @param[in]  in       Flujo RLE (los bytes que no completan un triple se ignoran).
+ * @param[in]  out      Destino de la salida.
+ * @param[out] out_len  Bytes entregados a @p out.
+ *
+ * @return DECODE_OK, DECODE_NO_SPACE (buffer fijo lleno) o DECODE_STOPPED (callback).
+ */
+decode_status_t rle_decode(byte_span_t in, decode_sink_t *out, size_t *out_len);
+
+/**
+ * @brief   Decodifica un flujo LZ78 completo hacia @p out.
+ *
+ * Con destinos en memoria cada frase se copia desde la posición donde ya se escribió su
+ * padre (sin diccionario de cadenas); con un callback se usa el decodificador incremental.
+ * A diferencia de `lz78_decompress()`, los símbolos NUL se escriben como cualquier otro
+ * byte, así que la salida de `lz78_compress()` vuelve exacta aunque el texto tenga NUL.
+ *
+ * @param[in]  in       Flujo LZ78 (los bytes que no completan un token se ignoran).
+ * @param[in]  out      Destino de la salida.
+ * @param[out] out_len  Bytes entregados a @p out (con DECODE_INVALID, los anteriores al token inválido).
+ *
+ * @return DECODE_OK, DECODE_INVALID, DECODE_NO_SPACE (buffer fijo lleno) o DECODE_STOPPED (callback).
+ */
+decode_status_t lz78_decode(byte_span_t in, decode_sink_t *out, size_t *out_len);
+
 
+// ====== Validación estructural ============
+
+/**
+ * @enum codec_class_t
+ * @brief Formatos con los que un flujo desencriptado es estructuralmente compatible.
+ *
+ * Es una máscara de bits: CODEC_AMBIGUOUS = CODEC_RLE | CODEC_LZ78.
+ */
+typedef enum {
+    CODEC_NONE = 0,         /**< Ningún formato: no vale la pena descomprimir. */
+    CODEC_RLE = 1,          /**< RLE plausible. */
+    CODEC_LZ78 = 2,         /**< LZ78 válido. */
+    CODEC_AMBIGUOUS = 3     /**< Ambos (en la práctica solo flujos muy cortos). */
+} codec_class_t;
+
+/**
+ * @brief   Clasifica un flujo desencriptado recorriendo sus triples una sola vez.
+ *
+ * - LZ78 es válido si cada índice es menor o igual que la cantidad de tokens anteriores;
+ *   es exactamente la condición con la que `lz78_decompress()` devuelve nullptr.
+ * - RLE es plausible si, hasta el primer símbolo NUL (donde termina el texto), toda
+ *   corrida tiene al menos una repetición y su símbolo es un carácter de texto (imprimible,
+ *   salto de línea, tabulación o un byte UTF-8 >= 0x80).
+ *
+ * El recorrido termina en cuanto ambos formatos quedan descartados, así que una clave
+ * equivocada suele rechazarse en los primeros triples.
+ *
+ * @param   dec  Flujo desencriptado.
+ * @param   len  Longitud en bytes (se ignoran los bytes que no completan un triple).
+ *
+ * @return  Máscara con los formatos compatibles.
+ */
+codec_class_t classify_stream(const uint8_t *dec, size_t len);
+
+/**
+ * @struct codec_classifier_t
+ * @brief Estado de `classify_stream()` para un flujo que llega por bloques.
+ */
+typedef struct {
+    size_t tokens;      /**< Triples revisados. */
+    bool rle_ok;        /**< Sigue siendo RLE plausible. */
+    bool rle_done;      /**< Se llegó al NUL que termina el texto RLE. */
+    bool lz_ok;         /**< Sigue siendo LZ78 válido. */
+} codec_classifier_t;
+
+/**
+ * @brief Inicializa un clasificador incremental.
+ */
+void classifier_init(codec_classifier_t *c);
+
+/**
+ * @brief Revisa un bloque más del flujo desencriptado.
+ *
+ * @param c    Clasificador.
+ * @param dec  Siguiente bloque; salvo el último, su longitud debe ser múltiplo de 3
+ *             para que los triples queden alineados.
+ * @param len  Longitud del bloque.
+ *
+ * @return `true` mientras el flujo siga siendo compatible con algún formato.
+ */
+bool classifier_feed(codec_classifier_t *c, const uint8_t *dec, size_t len);
+
+/**
+ * @brief Formatos compatibles con todo lo revisado hasta ahora.
+ */
+codec_class_t classifier_result(const codec_classifier_t *c);
+
+// ====== Compresores ============
+
+/**
+ * @brief   Comprime un texto con RLE en el formato que lee `rle_decompress()`.
+ *
+ * Cada corrida se escribe como el triple (0, repeticiones, símbolo); las corridas de más
+ * de 255 caracteres se parten en varios triples. La salida se reserva una sola vez con su
+ * tamaño exacto (una primera pasada cuenta los triples).
+ *
+ * @param   in       Texto a comprimir.
+ * @param   len      Longitud del texto.
+ * @param   out_len  Longitud de la salida en bytes.
+ *
+ * @return  Buffer comprimido; el usuario lo libera con `delete[]`.
+ */
+uint8_t *rle_compress(const char *in, size_t len, size_t *out_len);
+
+/**
+ * @brief   Comprime un texto con LZ78 en el formato que lee `lz78_decompress()`.
+ *
+ * El diccionario es un trie guardado en una tabla hash de direccionamiento abierto
+ * indexada por (frase padre, símbolo), así que cada carácter cuesta una búsqueda O(1).
+ * Como los índices son de 16 bits, solo se crean las primeras LZ78_MAX_INDEX frases;
+ * después el trie queda fijo y se siguen emitiendo tokens contra él.
+ *
+ * @param   in       Texto a comprimir. Puede contener bytes NUL: `lz78_decode()` los
+ *                   recupera, pero `lz78_decompress()` los descarta.
+ * @param   len      Longitud del texto.
+ * @param   out_len  Longitud de la salida en bytes.
+ *
+ * @return  Buffer comprimido; el usuario lo libera con `delete[]`.
+ */
+uint8_t *lz78_compress(const char *in, size_t len, size_t *out_len);
 
 #endif // COMPRESS_HPP
@@ -0,0 +1,85 @@
+/**
+ * @file daemon.hpp
+ * @brief Archivo de cabecera para el modo demonio (servidor por socket local)
+ *
+ * Este modulo contiene:
+ * daemon_main: Atiende trabajos por un socket Unix con un grupo de hilos permanente
+ *
+ * El proceso arranca una sola vez y resuelve los trabajos que llegan por el socket: cada
+ * trabajador conserva su memoria de trabajo entre archivos (buffer desencriptado,
+ * diccionario LZ78), así que la latencia por archivo es solo la búsqueda.
+ *
+ * Protocolo (por conexión, binario y sin escapes). Cada pedido es una línea de cabecera
+ * seguida de exactamente los bytes que anuncia:
+ *
+ * @code{.txt}
+ * PATH <id> <largo_ruta> <largo_pista>\n<ruta del encriptado><pista>
+ * DATA <id> <largo_cifrado> <largo_pista>\n<bytes cifrados><pista>
+ * @endcode
+ *
+ * `<id>` es un identificador del cliente (letras, dígitos, `_`, `-`, `.` o `:`). Cada
+ * resultado se envía apenas termina, en orden de terminación, como una línea JSON; si se
+ * encontró la clave, la línea va seguida de exactamente `len` bytes con el mensaje:
+ *
+ * @code{.txt}
+ * {"id":"7","found":true,"n":3,"k":90,"method":"RLE","len":1034,"ms":0.412}\n<1034 bytes>
+ * {"id":"8","found":false,"ms":1.870}\n
+ * @endcode
+ *
+ * Un texto cifrado vacío (`DATA` con largo 0 o `PATH` a un archivo vacío) se responde
+ * `found:false` sin buscar. Un pedido mal formado recibe `{"id":"","error":"..."}` y se
+ * cierra la conexión.
+ *
+ * Modelo de confianza: el protocolo no autentica a los clientes. Un pedido `PATH` lee
+ * cualquier archivo al que tenga acceso el usuario del demonio, así que el socket se crea
+ * con permisos 0600 y solo ese usuario puede conectarse. Para compartirlo se debe poner
+ * en una carpeta con los permisos adecuados, nunca relajar los del socket.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#ifndef DAEMON_HPP
+#define DAEMON_HPP
+
+#include <app.hpp>
+#include <keycache.hpp>
+
+// Límites de un pedido: identificador, ruta, texto cifrado y pista
+#define DAEMON_ID_MAX 64
+#define DAEMON_PATH_MAX 4096
+#define DAEMON_DATA_MAX ((size_t)1 << 30)
+#define DAEMON_HINT_MAX ((size_t)1 << 20)
+
+// Trabajos en cola por trabajador antes de frenar la lectura de los clientes
+#define DAEMON_QUEUE_PER_WORKER 4
+
+/**
+ * @brief Punto de entrada del modo demonio.
+ *
+ * @code{.txt}
+ * ./Desafio_1 --daemon /tmp/desafio.sock [-j hilos] [--cache claves|none]
+ * @endcode
+ *
+ * Opciones:
+ *  - `--daemon <socket>`: ruta del socket Unix. Se reemplaza un socket abandonado; si la
+ *    ruta es otro tipo de archivo o hay un demonio escuchando en ella, no arranca.
+ *  - `-j <hilos>`: trabajadores (0 o sin indicar: todos los núcleos).
+ *  - `--cache <archivo>`: caché de claves compartida (ver `batch_main()`).
+ *
+ * Cada conexión tiene un hilo lector que pasa los pedidos a una cola acotada; si la cola
+ * se llena, el lector deja de leer y el cliente queda frenado por el propio socket. Con
+ * SIGINT o SIGTERM deja de aceptar conexiones, termina los trabajos en cola y borra el socket.
+ *
+ * @param argc Cantidad de argumentos de `main`.
+ * @param argv Argumentos de `main`.
+ *
+ * @return OK si el servidor terminó normalmente.
+ * @return ERROR si las opciones son inválidas o no se pudo crear el socket.
+ */
+my_error_t daemon_main(int argc, char **argv);
+
+#endif // DAEMON_HPP
@@ -0,0 +1,92 @@
+/**
+ * @file input.hpp
+ * @brief Archivo de cabecera para la capa de entrada por mapeo de memoria
+ *
+ * Este modulo contiene:
+ * input_open: Mapea un archivo completo como vista de solo lectura
+ * input_open_text: Igual que input_open, garantizando un NUL al final para usarlo como C-string
+ * input_close: Libera la vista
+ * input_prefetch: Trae a memoria el contenido de una vista abierta
+ *
+ * En sistemas POSIX el archivo se mapea con `mmap` y se marca con `madvise` como lectura
+ * secuencial, así que el texto cifrado y la pista llegan a `finder()` sin copias y la
+ * búsqueda empieza sin esperar a que se lea todo el archivo. En otros sistemas se lee
+ * con una única llamada a `fread` en modo binario.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @struct input_view_t
+ * @brief Vista de solo lectura al contenido de un archivo.
+ */
+typedef struct {
+    const uint8_t *data;    /**< Primer byte del contenido. */
+    size_t len;             /**< Longitud del contenido en bytes. */
+    void *map_base;         /**< Dirección del mapeo (nullptr si no se mapeó). */
+    size_t map_len;         /**< Longitud del mapeo. */
+    uint8_t *owned;         /**< Copia propia cuando no se pudo usar el mapeo directamente. */
+} input_view_t;
+
+/**
+ * @brief Abre un archivo como vista de solo lectura.
+ *
+ * No imprime nada si falla: el llamador reporta el error en su propio formato (mensaje en
+ * orden, campo JSON o respuesta del demonio).
+ *
+ * @param[in]  path  Ruta al archivo.
+ * @param[out] view  Vista resultante; liberar con `input_close()`.
+ *
+ * @return `true` si se pudo abrir y no está vacío, `false` en caso contrario.
+ */
+bool input_open(const char *path, input_view_t *view);
+
+/**
+ * @brief Abre un archivo de texto garantizando que `data[len] == '\0'`.
+ *
+ * Cuando el tamaño no es múltiplo de la página, el resto de la última página mapeada
+ * ya está en cero y la vista se usa tal cual. Solo si el archivo termina justo en un
+ * límite de página se hace una copia con el terminador.
+ *
+ * @param[in]  path  Ruta al archivo.
+ * @param[out] view  Vista resultante; liberar con `input_close()`.
+ *
+ * @return `true` si se pudo abrir y no está vacío, `false` en caso contrario.
+ */
+bool input_open_text(const char *path, input_view_t *view);
+
+/**
+ * @brief Contenido de una vista abierta con `input_open_text()` como C-string.
+ */
+inline const char *input_cstr(const input_view_t *view)
+{
+    return (const char *)view->data;
+}
+
+/**
+ * @brief Trae a memoria todas las páginas de la vista.
+ *
+ * `madvise` solo pide la lectura anticipada; esta función espera a que termine tocando
+ * un byte por página, así que la lectura del disco ocurre en el hilo que la llama y no en
+ * el que después recorre los datos. Con la lectura por `fread` no hace nada.
+ *
+ * @param[in] view  Vista abierta con `input_open()` o `input_open_text()`.
+ */
+void input_prefetch(const input_view_t *view);
+
+/**
+ * @brief Libera el mapeo o la copia de una vista. Es seguro llamarla dos veces.
+ */
+void input_close(input_view_t *view);
+
+#endif // INPUT_HPP
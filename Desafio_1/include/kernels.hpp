@@ -0,0 +1,89 @@
+/**
+ * @file kernels.hpp
+ * @brief Archivo de cabecera para los kernels vectorizados de desencriptado
+ *
+ * Este modulo contiene:
+ * decrypt_into: XOR con la clave y rotación a la derecha de cada byte de un buffer
+ * decrypt_into_key: Desencriptado con una clave XOR de varios bytes que se repite
+ * kernels_active_isa: Conjunto de instrucciones elegido en tiempo de ejecución
+ *
+ * Cada kernel tiene una versión escalar y versiones SSE2, AVX2 y AVX-512 (BW).
+ * La mejor versión soportada por la CPU se elige una única vez consultando CPUID;
+ * todas producen exactamente los mismos bytes que la versión escalar.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#ifndef KERNELS_HPP
+#define KERNELS_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+//Libreria de las operaciones de bit
+#include <compress.hpp>
+
+// Bytes de la clave repetida que usa decrypt_into_key() en cada bloque (límite de la longitud de clave)
+#define KEY_TILE 1024
+
+/**
+ * @enum kernel_isa_t
+ * @brief Conjuntos de instrucciones para los que existe una versión de los kernels.
+ */
+typedef enum {
+    ISA_SCALAR,     /**< Bucle escalar con `ror_8()`, siempre disponible. */
+    ISA_SSE2,       /**< Vectores de 128 bits. */
+    ISA_AVX2,       /**< Vectores de 256 bits. */
+    ISA_AVX512      /**< Vectores de 512 bits (requiere AVX-512BW). */
+} kernel_isa_t;
+
+/**
+ * @brief Desencripta @p len bytes de @p in en @p out: `out[i] = ror_8(in[i] ^ k, n)`.
+ *
+ * @param[in]  in   Buffer encriptado.
+ * @param[out] out  Buffer destino de al menos @p len bytes (puede ser igual a @p in).
+ * @param[in]  len  Cantidad de bytes a procesar.
+ * @param[in]  n    Rotación a la derecha (0 a 7).
+ * @param[in]  k    Clave XOR.
+ */
+void decrypt_into(const uint8_t* in, uint8_t* out, size_t len, uint8_t n, uint8_t k);
+
+/**
+ * @brief Desencripta con una clave XOR de @p key_len bytes que se repite:
+ *        `out[i] = ror_8(in[i] ^ key[i % key_len], n)`.
+ *
+ * La XOR se aplica por bloques contra la clave ya repetida (el compilador la vectoriza) y
+ * la rotación la hace `decrypt_into()` con clave 0 sobre el mismo buffer.
+ *
+ * @param[in]  in       Buffer encriptado.
+ * @param[out] out      Buffer destino de al menos @p len bytes (puede ser igual a @p in).
+ * @param[in]  len      Cantidad de bytes a procesar.
+ * @param[in]  n        Rotación a la derecha (0 a 7).
+ * @param[in]  key      Clave de @p key_len bytes.
+ * @param[in]  key_len  Longitud de la clave (1 a KEY_TILE).
+ */
+void decrypt_into_key(const uint8_t* in, uint8_t* out, size_t len, uint8_t n, const uint8_t* key, size_t key_len);
+
+/**
+ * @brief Conjunto de instrucciones que usan actualmente los kernels.
+ */
+kernel_isa_t kernels_active_isa();
+
+/**
+ * @brief Fuerza el uso de un conjunto de instrucciones (pruebas y benchmarks).
+ *
+ * @param isa Conjunto deseado.
+ * @return `false` si la CPU o el compilador no lo soportan; en ese caso no cambia nada.
+ */
+bool kernels_force_isa(kernel_isa_t isa);
+
+/**
+ * @brief Nombre legible de un conjunto de instrucciones ("scalar", "sse2", "avx2", "avx512").
+ */
+const char* kernels_isa_name(kernel_isa_t isa);
+
+#endif // KERNELS_HPP
@@ -0,0 +1,169 @@
+/**
+ * @file keycache.hpp
+ * @brief Archivo de cabecera para la caché persistente de claves resueltas
+ *
+ * Este modulo contiene:
+ * content_hash: Hash rápido de 64 bits del contenido cifrado
+ * keycache_load / keycache_free: Carga y liberación de la caché
+ * keycache_lookup: Busca la clave de un archivo ya resuelto
+ * keycache_store: Guarda una clave nueva (memoria y disco)
+ * keycache_recent: Claves resueltas más recientemente
+ * finder_cached: `finder_auto()` con la caché delante
+ *
+ * La caché es un archivo de texto con una línea por archivo resuelto:
+ *
+ * @code{.txt}
+ * <hash en hex> <longitud> <n> <k> <RLE|LZ78>
+ * @endcode
+ *
+ * Las líneas nuevas se agregan al final, así que varias ejecuciones pueden compartir el
+ * archivo; al cargar, la última línea de cada hash es la que vale. Un acierto por hash
+ * cuesta un desencriptado y una descompresión en lugar de la búsqueda completa, y como los
+ * productores reutilizan claves entre archivos, las últimas claves resueltas se prueban
+ * antes de buscar en archivos nuevos. En ambos casos la pista se verifica igual que en la
+ * búsqueda completa, así que una entrada equivocada solo cuesta un intento.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#ifndef KEYCACHE_HPP
+#define KEYCACHE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+
+#include <solver.hpp>
+
+// Archivo por defecto (en la carpeta de trabajo) y variable de entorno que lo reemplaza
+#define KEYCACHE_FILE ".desafio_claves"
+#define KEYCACHE_ENV "DESAFIO_CACHE"
+
+// Claves recientes que se prueban antes de la búsqueda completa
+#define KEYCACHE_RECENT 8
+
+/**
+ * @struct keycache_entry_t
+ * @brief Un archivo resuelto.
+ */
+typedef struct {
+    uint64_t hash;      /**< `content_hash()` del texto cifrado. */
+    uint64_t len;       /**< Longitud del texto cifrado (descarta colisiones triviales). */
+    uint8_t n;          /**< Rotación. */
+    uint8_t k;          /**< Clave XOR. */
+    bool lz78;          /**< Método: LZ78 (`true`) o RLE (`false`). */
+} keycache_entry_t;
+
+/**
+ * @struct keycache_t
+ * @brief Caché cargada en memoria; se puede compartir entre hilos.
+ */
+typedef struct {
+    char *path;                             /**< Archivo de la caché (nullptr: solo en memoria). */
+    keycache_entry_t *items;                /**< Entradas en orden de llegada. */
+    size_t count;                           /**< Entradas válidas. */
+    size_t cap;                             /**< Capacidad reservada. */
+    uint16_t recent[KEYCACHE_RECENT];       /**< Candidatos más recientes primero. */
+    size_t n_recent;                        /**< Claves recientes válidas. */
+    std::mutex lock;                        /**< Protege entradas, recientes y archivo. */
+} keycache_t;
+
+/**
+ * @brief Hash de 64 bits del contenido, pensado para archivos grandes (8 bytes por paso).
+ *
+ * No es criptográfico: solo identifica archivos repetidos. Cada acierto se verifica
+ * con la pista antes de usarse.
+ */
+uint64_t content_hash(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Ruta de la caché: la variable de entorno KEYCACHE_ENV o KEYCACHE_FILE.
+ *
+ * @return nullptr si la variable vale "none" (caché solo en memoria).
+ */
+const char *keycache_default_path();
+
+/**
+ * @brief Carga la caché desde @p path.
+ *
+ * Un archivo inexistente deja la caché vacía (se crea al guardar la primera clave);
+ * las líneas mal formadas se ignoran. Con @p path nulo la caché solo vive en memoria.
+ *
+ * @param[out] c     Caché a inicializar.
+ * @param[in]  path  Archivo de la caché.
+ */
+void keycache_load(keycache_t *c, const char *path);
+
+/**
+ * @brief Libera la memoria de la caché (el archivo ya está al día).
+ */
+void keycache_free(keycache_t *c);
+
+/**
+ * @brief Busca un archivo ya resuelto.
+ *
+ * @param[in]  c     Caché.
+ * @param[in]  hash  `content_hash()` del texto cifrado.
+ * @param[in]  len   Longitud del texto cifrado.
+ * @param[out] out   Entrada encontrada.
+ *
+ * @return `true` si hay una entrada con ese hash y longitud.
+ */
+bool keycache_lookup(keycache_t *c, uint64_t hash, uint64_t len, keycache_entry_t *out);
+
+/**
+ * @brief Guarda una clave resuelta y la marca como la más reciente.
+ *
+ * La línea se agrega al archivo de inmediato, así que una ejecución interrumpida no
+ * pierde las claves ya encontradas.
+ *
+ * @return `false` si no se pudo escribir el archivo (la entrada queda en memoria).
+ */
+bool keycache_store(keycache_t *c, const keycache_entry_t *e);
+
+/**
+ * @brief Copia las claves recientes (índices de candidato, la más reciente primero).
+ *
+ * @param[in]  c    Caché.
+ * @param[out] out  Arreglo de al menos KEYCACHE_RECENT posiciones.
+ *
+ * @return Cantidad de claves copiadas.
+ */
+size_t keycache_recent(keycache_t *c, uint16_t *out);
+
+/**
+ * @brief `finder_auto()` con la caché de claves delante.
+ *
+ *  1. Si el hash del texto cifrado está en la caché, se prueba solo esa clave.
+ *  2. Si no, se prueban las KEYCACHE_RECENT claves más recientes con `finder_keys()`; su
+ *     acierto solo se acepta si el mensaje es texto limpio (ASCII o UTF-8 válido).
+ *  3. Si ninguna confirma la pista, `finder_auto()` y la clave encontrada se guarda.
+ *
+ * Con @p c nulo equivale a `finder_auto()`.
+ *
+ * @param[in] c              Caché (puede ser nullptr).
+ * @param[in] enc            Puntero al buffer con el texto encriptado.
+ * @param[in] enc_len        Longitud del buffer encriptado.
+ * @param[in] know_fragment  Fragmento de texto conocido que debe aparecer en el mensaje descifrado.
+ * @param[out] out_msg       Puntero de salida que contendrá el mensaje descifrado
+ * @param[out] out_method    Puntero de salida que contendrá el método usado ("RLE" o "LZ78").
+ * @param[out] out_n         Puntero de salida para el valor de rotación `n` encontrado.
+ * @param[out] out_k         Puntero de salida para la clave XOR `k` encontrada.
+ * @param[in] n_threads      Hilos para la fuerza bruta; 0 usa todos los núcleos.
+ *
+ * @return `true` si se encuentra una combinación válida, `false` en caso contrario.
+ *
+ * @note Se prefiere una clave ya probada: si varias claves producen un mensaje de texto limpio
+ *       con la pista, una clave reciente gana sobre la que habría elegido `finder_auto()`, así
+ *       que con la misma entrada el resultado puede depender de lo que haya en la caché. Con
+ *       `DESAFIO_CACHE=none` (o `--cache none`) cada ejecución empieza sin claves recientes.
+ */
+bool finder_cached(keycache_t *c, const uint8_t *enc, size_t enc_len, const char *know_fragment,
+                   char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k, unsigned int n_threads);
+
+#endif // KEYCACHE_HPP
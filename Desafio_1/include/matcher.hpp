@@ -0,0 +1,107 @@
+/**
+ * @file matcher.hpp
+ * @brief Archivo de cabecera para la búsqueda de la pista en el texto descifrado
+ *
+ * Este modulo contiene:
+ * matcher_init / matcher_free: Preprocesa la pista una sola vez por archivo
+ * matcher_find: Busca la pista en un texto completo
+ * matcher_feed: Busca la pista en un texto que llega por bloques
+ *
+ * Una pista cuya primera línea es MATCHER_ALT_HEADER contiene varias alternativas, una por
+ * línea, y el texto coincide si contiene cualquiera de ellas:
+ *
+ * @code{.txt}
+ * #alternativas
+ * Hola Mundo
+ * Quijote
+ * @endcode
+ *
+ * Cualquier otra pista es un único fragmento literal, incluidos sus saltos de línea.
+ *
+ * Todo se construye una vez y es de solo lectura durante la búsqueda, así que todos los
+ * hilos comparten el mismo buscador para los N_CANDIDATES candidatos:
+ *  - **Una alternativa, texto completo**: `memchr` (vectorizado en la biblioteca estándar)
+ *    salta al siguiente primer byte de la pista y `memcmp` confirma; si el primer byte es
+ *    demasiado frecuente en el texto se pasa a Horspool, cuya tabla de saltos ya está lista.
+ *  - **Varias alternativas o texto por bloques**: autómata de Aho-Corasick (con una sola
+ *    alternativa es el autómata de KMP) sobre clases de bytes: un acceso a tabla por byte,
+ *    sin retrocesos, y el estado se conserva entre bloques.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#ifndef MATCHER_HPP
+#define MATCHER_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+// Primera línea de una pista con varias alternativas
+#define MATCHER_ALT_HEADER "#alternativas"
+
+/**
+ * @struct hint_matcher_t
+ * @brief Pista preprocesada: alternativas, tabla de Horspool y autómata.
+ */
+typedef struct {
+    size_t n_pats;          /**< Alternativas no vacías (0: la pista vacía siempre coincide). */
+    const char **pats;      /**< Inicio de cada alternativa (apuntan a una copia propia de la pista). */
+    size_t *lens;           /**< Longitud de cada alternativa. */
+    size_t max_len;         /**< Longitud de la alternativa más larga. */
+    char *copy;             /**< Copia de la pista con las líneas separadas. */
+
+    size_t shift[256];      /**< Horspool (solo con una alternativa): salto según el último byte de la ventana. */
+
+    uint8_t cls[256];       /**< Clase de cada byte: 0 para los que no aparecen en la pista. */
+    size_t n_cls;           /**< Cantidad de clases. */
+    uint32_t *next;         /**< Transiciones: next[estado * n_cls + clase]. */
+    bool *accept;           /**< El estado completa alguna alternativa. */
+    size_t n_states;        /**< Estados del autómata (el 0 es el inicial). */
+} hint_matcher_t;
+
+/**
+ * @brief Prepara el buscador para la pista @p hint.
+ *
+ * Con la cabecera MATCHER_ALT_HEADER, las líneas siguientes son las alternativas (se
+ * descarta un `\r` final y se ignoran las líneas vacías); sin ella, la pista completa es la
+ * única alternativa. Cada alternativa queda terminada en NUL en una copia propia, así que
+ * @p hint puede liberarse después.
+ *
+ * @param[out] m     Buscador a inicializar; liberar con `matcher_free()`.
+ * @param[in]  hint  Pista terminada en NUL.
+ */
+void matcher_init(hint_matcher_t *m, const char *hint);
+
+/**
+ * @brief Libera la memoria del buscador.
+ */
+void matcher_free(hint_matcher_t *m);
+
+/**
+ * @brief Indica si alguna alternativa aparece en @p text.
+ *
+ * @param[in] m     Buscador.
+ * @param[in] text  Texto (no necesita terminador; un NUL se trata como cualquier byte).
+ * @param[in] len   Longitud del texto.
+ *
+ * @return `true` si hay coincidencia.
+ */
+bool matcher_find(const hint_matcher_t *m, const char *text, size_t len);
+
+/**
+ * @brief Avanza la búsqueda con un bloque de texto.
+ *
+ * @param[in]     m      Buscador.
+ * @param[in,out] state  Estado del autómata (0 al empezar un texto nuevo).
+ * @param[in]     chunk  Bloque de texto.
+ * @param[in]     len    Longitud del bloque.
+ *
+ * @return `true` si alguna alternativa termina dentro del bloque.
+ */
+bool matcher_feed(const hint_matcher_t *m, uint32_t *state, const char *chunk, size_t len);
+
+#endif // MATCHER_HPP
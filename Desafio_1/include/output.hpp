@@ -0,0 +1,168 @@
+/**
+ * @file output.hpp
+ * @brief Archivo de cabecera para la escritura de los mensajes recuperados
+ *
+ * Este modulo contiene:
+ * output_writev: Escribe varios bloques en un descriptor, reintentando las escrituras parciales (POSIX)
+ * output_stdout: Escribe varios bloques en la salida estándar
+ * output_init: Destino vacío (los mensajes no se guardan)
+ * output_open_dir / output_open_archive: Destino de los mensajes
+ * output_make_dirs: Crea una carpeta y las que le faltan en la ruta
+ * output_message_name: Nombre del archivo de un mensaje en la carpeta
+ * output_message: Escribe un mensaje en el destino
+ * output_close: Cierra el destino (y escribe el índice del archivo)
+ *
+ * Los mensajes se escriben directamente desde el buffer que entrega el solver, con
+ * `writev`/`pwrite` y sin pasar por iostreams ni por el buffer de `stdio`. En sistemas sin
+ * esas llamadas se usa `fwrite` con el mismo resultado. Hay dos destinos:
+ *  - **Carpeta**: un archivo por mensaje; `EncriptadoN.txt` produce `mensajeN.txt`.
+ *  - **Archivo único**: todos los mensajes concatenados en un archivo, más un índice de
+ *    texto `<archivo>.idx` con una línea por mensaje:
+ *
+ * @code{.txt}
+ * <desplazamiento> <longitud> <ruta del encriptado>
+ * @endcode
+ *
+ * Varios hilos pueden escribir a la vez: en el archivo único cada mensaje reserva su
+ * desplazamiento y se escribe con `pwrite` fuera del candado (con `fwrite`, dentro de él).
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#ifndef OUTPUT_HPP
+#define OUTPUT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OUTPUT_POSIX 1
+#include <sys/uio.h>
+#endif
+
+// Extensión del índice del archivo único
+#define OUTPUT_INDEX_EXT ".idx"
+
+#ifdef OUTPUT_POSIX
+typedef struct iovec output_iov_t;
+#else
+/**
+ * @struct output_iov_t
+ * @brief Bloque a escribir (mismos campos que `struct iovec`).
+ */
+typedef struct {
+    void *iov_base;     /**< Inicio del bloque. */
+    size_t iov_len;     /**< Longitud del bloque. */
+} output_iov_t;
+#endif
+
+/**
+ * @enum output_kind_t
+ * @brief Tipo de destino de los mensajes.
+ */
+typedef enum {
+    OUTPUT_NONE,        /**< Los mensajes no se guardan. */
+    OUTPUT_DIR,         /**< Un archivo por mensaje dentro de una carpeta. */
+    OUTPUT_ARCHIVE      /**< Un archivo con todos los mensajes y su índice. */
+} output_kind_t;
+
+/**
+ * @struct output_t
+ * @brief Destino de los mensajes; se puede compartir entre hilos.
+ */
+typedef struct {
+    output_kind_t kind;     /**< Tipo de destino. */
+    char *dir;              /**< Carpeta (OUTPUT_DIR). */
+#ifdef OUTPUT_POSIX
+    int fd;                 /**< Archivo único (OUTPUT_ARCHIVE). */
+#else
+    FILE *file;             /**< Archivo único (OUTPUT_ARCHIVE). */
+#endif
+    uint64_t offset;        /**< Próximo desplazamiento libre del archivo único. */
+    FILE *index;            /**< Índice del archivo único. */
+    std::mutex lock;        /**< Protege el desplazamiento y el índice. */
+} output_t;
+
+#ifdef OUTPUT_POSIX
+/**
+ * @brief Escribe todos los bloques de @p iov en @p fd.
+ *
+ * Reintenta las escrituras parciales y las interrumpidas por señales, así que sirve para
+ * sockets y para mensajes de varios GB. Modifica @p iov.
+ *
+ * @return `false` si falla una escritura.
+ */
+bool output_writev(int fd, output_iov_t *iov, int n_iov);
+#endif
+
+/**
+ * @brief Escribe todos los bloques de @p iov en la salida estándar, después de lo que ya
+ * estuviera en el buffer de `stdout`. Modifica @p iov.
+ *
+ * @return `false` si falla una escritura.
+ */
+bool output_stdout(output_iov_t *iov, int n_iov);
+
+/**
+ * @brief Deja el destino en OUTPUT_NONE; `output_close()` es seguro después.
+ */
+void output_init(output_t *o);
+
+/**
+ * @brief Prepara la escritura de un archivo por mensaje en @p dir (se crea si no existe).
+ *
+ * @return `false` si no se pudo crear la carpeta.
+ */
+bool output_open_dir(output_t *o, const char *dir);
+
+/**
+ * @brief Prepara la escritura de todos los mensajes en @p path y su índice en `<path>.idx`.
+ *
+ * @return `false` si no se pudo crear alguno de los dos archivos.
+ */
+bool output_open_archive(output_t *o, const char *path);
+
+/**
+ * @brief Crea la carpeta @p dir y las que le falten en la ruta (como `mkdir -p`).
+ *
+ * @return `true` si al final @p dir es una carpeta.
+ */
+bool output_make_dirs(const char *dir);
+
+/**
+ * @brief Nombre (sin carpeta) del archivo con el mensaje de @p enc_path.
+ *
+ * Se cambia el último `Encriptado` del nombre por `mensaje`; si el nombre no lo contiene,
+ * se le agrega `.mensaje`. Dos encriptados de carpetas distintas con el mismo nombre dan el
+ * mismo mensaje: el llamador debe descartar esas colisiones antes de escribir.
+ *
+ * @return Nombre en memoria dinámica (liberar con `delete[]`).
+ */
+char *output_message_name(const char *enc_path);
+
+/**
+ * @brief Escribe un mensaje recuperado.
+ *
+ * @param[in] o         Destino (con OUTPUT_NONE no hace nada).
+ * @param[in] enc_path  Ruta del archivo encriptado (da el nombre o la entrada del índice).
+ * @param[in] msg       Mensaje.
+ * @param[in] len       Longitud del mensaje.
+ *
+ * @return `false` si no se pudo escribir.
+ */
+bool output_message(output_t *o, const char *enc_path, const char *msg, size_t len);
+
+/**
+ * @brief Cierra el destino y termina de escribir el índice.
+ *
+ * @return `false` si falló el cierre del archivo único o de su índice (se cierran ambos).
+ */
+bool output_close(output_t *o);
+
+#endif // OUTPUT_HPP
@@ -4,6 +4,16 @@
  *
  * Este modulo contiene:
  * finder: Metodo de busqueda por medio de fuerza bruta
+ * finder_parallel: Busqueda de fuerza bruta repartida entre varios hilos
+ * finder_known_plaintext: Recuperación de la clave a partir del fragmento conocido
+ * finder_auto: Estrategia completa (texto conocido y luego fuerza bruta)
+ * finder_keys: Prueba solo una lista de combinaciones (n, k)
+ * finder_stream: Búsqueda por bloques con memoria acotada para archivos enormes
+ * finder_multikey: Claves XOR de varios bytes que se repiten
+ * encrypt_buffer / encrypt_buffer_key: Cifrado inverso (corpus de prueba)
+ *
+ * Las etapas internas de la búsqueda (prefiltro, histogramas, orden de candidatos) están
+ * en solver_internal.hpp.
  *
  * @authors Julián Sánchez
  *          Jaider Bedoya
@@ -20,22 +30,54 @@
 #include <cstdint>
 #include <cctype>
 #include <cstring>
+#include <thread>
+#include <atomic>
+#include <mutex>
 
 //Libreria de las operaciones de bit y descompresión
 #include <compress.hpp>
+#include <kernels.hpp>
+#include <trace.hpp>
+#include <matcher.hpp>
 
 // Macro para la comparación del porcentaje de texto imprimible
 #define RATIO_MIN 0.3
 
+// Espacio de busqueda: rotaciones n en [ROT_MIN, ROT_MAX] y claves k en [0, KEY_SPACE)
+#define ROT_MIN 1
+#define ROT_MAX 7
+#define KEY_SPACE 256
+#define N_CANDIDATES ((ROT_MAX - ROT_MIN + 1) * KEY_SPACE)
+
+// Memoria por defecto del modo por bloques y tamaño del primer bloque (múltiplo de 3)
+#define STREAM_MEM_DEFAULT ((size_t)64 << 20)
+#define STREAM_PROBE (3 * 16384)
+
+// Claves de varios bytes: longitud máxima, período máximo de las columnas (mcm con 3),
+// bytes analizados para detectar la longitud, mínimo de bytes por columna, fracción del
+// mejor índice de coincidencia aceptada; para el byte de índice bajo de LZ78, tokens
+// analizados, opciones por byte y combinaciones que se verifican
+#define KEY_LEN_MAX 16
+#define KEY_PERIOD_MAX (3 * KEY_LEN_MAX)
+#define KEY_LEN_SAMPLE ((size_t)1 << 20)
+#define KEY_LEN_MIN_COLUMN 32
+#define KEY_LEN_IC_RATIO 0.85
+#define KEY_LZ78_TOKENS 8192
+#define KEY_LZ78_TIES 8
+#define KEY_LZ78_COMBOS 64
+
 using namespace std;
 
 /**
  * @brief Intenta descifrar un mensaje encriptado mediante fuerza bruta
  *        probando todas las combinaciones posibles de rotación @p n y clave XOR @p k.
  *
- * Esta función recorre todas las combinaciones de valores de `n` (1 a 7) y `k` (0 a 255),
- * aplicando el descifrado con `decrypt_buffer()`. Luego, valida si el resultado
- * contiene un número suficiente de caracteres imprimibles usando `printable_ratio()`.
+ * Esta función recorre todas las combinaciones de valores de `n` (1 a 7) y `k` (0 a 255).
+ * Primero construye un único histograma de bytes de @p enc y, con él, descarta sin
+ * desencriptar las combinaciones cuyo resultado no tendría un número suficiente de
+ * caracteres imprimibles (`printable_ratio()`). Solo los candidatos que superan
+ * RATIO_MIN se descifran con `decrypt_buffer()`, empezando por los más probables según
+ * `rank_candidates()`: la clave correcta suele estar entre los primeros intentos.
  *
  * Si el texto descifrado parece válido, intenta descomprimirlo primero con **RLE**
  * y después con **LZ78**, verificando si la salida contiene el fragmento conocido (`know_fragment`).
@@ -52,8 +94,196 @@ using namespace std;
  * @return `true` si se encuentra una combinación válida que descifra y descomprime el mensaje,
  *         `false` en caso contrario.
  *
+ * @note La memoria de trabajo (buffer desencriptado, diccionario LZ78...) se reserva una vez
+ *       por búsqueda y se reutiliza en cada candidato: el ciclo de búsqueda no reserva memoria.
  */
 bool finder(const uint8_t* enc, size_t enc_len, const char* know_fragment, char** out_msg, char** out_method, uint8_t* out_n, uint8_t* out_k);
 
+/**
+ * @brief Versión multihilo de `finder()`.
+ *
+ * Reparte las N_CANDIDATES combinaciones (n, k) entre @p n_threads hilos. Cada hilo
+ * toma el siguiente candidato libre en el mismo orden del recorrido serial (del más al
+ * menos probable) y, en cuanto alguno encuentra el fragmento, los demás abandonan los
+ * candidatos posteriores a él.
+ *
+ * Entre varias coincidencias se conserva la de menor posición en ese orden, por lo que el
+ * resultado es siempre el mismo que devolvería `finder()`.
+ *
+ * @param[in] enc            Puntero al buffer con el texto encriptado.
+ * @param[in] enc_len        Longitud del buffer encriptado.
+ * @param[in] know_fragment  Fragmento de texto conocido que debe aparecer en el mensaje descifrado.
+ * @param[out] out_msg       Puntero de salida que contendrá el mensaje descifrado
+ * @param[out] out_method    Puntero de salida que contendrá el método usado ("RLE" o "LZ78").
+ * @param[out] out_n         Puntero de salida para el valor de rotación `n` encontrado.
+ * @param[out] out_k         Puntero de salida para la clave XOR `k` encontrada.
+ * @param[in] n_threads      Número de hilos; 0 usa `thread::hardware_concurrency()`.
+ *
+ * @return `true` si se encuentra una combinación válida, `false` en caso contrario.
+ */
+bool finder_parallel(const uint8_t* enc, size_t enc_len, const char* know_fragment, char** out_msg, char** out_method, uint8_t* out_n, uint8_t* out_k, unsigned int n_threads);
+
+/**
+ * @brief Recupera (n, k) con ataque de texto conocido en lugar de fuerza bruta.
+ *
+ * Usa la estructura de los formatos comprimidos para calcular directamente los pares
+ * consistentes con el fragmento, y solo esos se desencriptan y descomprimen:
+ *  - **RLE**: los símbolos del fragmento ocupan una posición de cada tres en triples
+ *    consecutivos; la XOR entre posiciones elimina la clave y cada aparición fija k.
+ *  - **LZ78**: el primer token siempre tiene índice 0, lo que fija k = enc[0]; la rotación
+ *    se filtra con los caracteres del fragmento presentes en la columna de símbolos.
+ *
+ * Normalmente quedan unos pocos candidatos en lugar de N_CANDIDATES, y se verifican en el
+ * orden de `rank_candidates()`, el mismo de la búsqueda completa. Si ninguno confirma
+ * la pista (por ejemplo, un formato que no sigue estas reglas), retorna `false` y el
+ * llamador puede recurrir a `finder_parallel()`.
+ *
+ * @param[in] enc            Puntero al buffer con el texto encriptado.
+ * @param[in] enc_len        Longitud del buffer encriptado.
+ * @param[in] know_fragment  Fragmento de texto conocido que debe aparecer en el mensaje descifrado.
+ * @param[out] out_msg       Puntero de salida que contendrá el mensaje descifrado
+ * @param[out] out_method    Puntero de salida que contendrá el método usado ("RLE" o "LZ78").
+ * @param[out] out_n         Puntero de salida para el valor de rotación `n` encontrado.
+ * @param[out] out_k         Puntero de salida para la clave XOR `k` encontrada.
+ *
+ * @return `true` si algún candidato consistente se confirma, `false` en caso contrario.
+ */
+bool finder_known_plaintext(const uint8_t* enc, size_t enc_len, const char* know_fragment, char** out_msg, char** out_method, uint8_t* out_n, uint8_t* out_k);
+
+/**
+ * @brief Estrategia completa de búsqueda usada por la aplicación.
+ *
+ * Intenta `finder_known_plaintext()` y, si ningún candidato consistente se confirma,
+ * recurre a `finder_parallel()` con @p n_threads hilos (1 = búsqueda serial).
+ *
+ * @param[in] enc            Puntero al buffer con el texto encriptado.
+ * @param[in] enc_len        Longitud del buffer encriptado.
+ * @param[in] know_fragment  Fragmento de texto conocido que debe aparecer en el mensaje descifrado.
+ * @param[out] out_msg       Puntero de salida que contendrá el mensaje descifrado
+ * @param[out] out_method    Puntero de salida que contendrá el método usado ("RLE" o "LZ78").
+ * @param[out] out_n         Puntero de salida para el valor de rotación `n` encontrado.
+ * @param[out] out_k         Puntero de salida para la clave XOR `k` encontrada.
+ * @param[in] n_threads      Hilos para la fuerza bruta; 0 usa todos los núcleos.
+ *
+ * @return `true` si se encuentra una combinación válida, `false` en caso contrario.
+ */
+bool finder_auto(const uint8_t* enc, size_t enc_len, const char* know_fragment, char** out_msg, char** out_method, uint8_t* out_n, uint8_t* out_k, unsigned int n_threads);
+
+/**
+ * @brief Prueba solo las combinaciones de @p cands, en el orden dado.
+ *
+ * Cada candidato se verifica igual que en `finder()` (desencriptado, clasificación,
+ * descompresión y búsqueda del fragmento), pero sin prefiltro ni recorrido del espacio
+ * completo. Lo usa la caché de claves (keycache.hpp) para probar primero las claves ya
+ * conocidas: un acierto cuesta un desencriptado y una descompresión.
+ *
+ * @param[in] enc            Puntero al buffer con el texto encriptado.
+ * @param[in] enc_len        Longitud del buffer encriptado.
+ * @param[in] know_fragment  Fragmento de texto conocido que debe aparecer en el mensaje descifrado.
+ * @param[in] cands          Índices de candidato `(n - ROT_MIN) * KEY_SPACE + k`.
+ * @param[in] n_cands        Cantidad de candidatos.
+ * @param[out] out_msg       Puntero de salida que contendrá el mensaje descifrado
+ * @param[out] out_method    Puntero de salida que contendrá el método usado ("RLE" o "LZ78").
+ * @param[out] out_n         Puntero de salida para el valor de rotación `n` encontrado.
+ * @param[out] out_k         Puntero de salida para la clave XOR `k` encontrada.
+ *
+ * @return `true` si algún candidato de la lista confirma la pista.
+ */
+bool finder_keys(const uint8_t *enc, size_t enc_len, const char *know_fragment, const uint16_t *cands, size_t n_cands,
+                 char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k);
+
+/**
+ * @brief Búsqueda con memoria acotada: el archivo cifrado se procesa por bloques y el
+ *        mensaje se escribe directamente en @p out_path.
+ *
+ * Ni el texto cifrado, ni el desencriptado, ni el mensaje se cargan completos:
+ *  1. Una pasada por bloques arma el histograma y deja los candidatos del prefiltro.
+ *  2. Cada candidato desencripta bloque a bloque, los clasifica con `classifier_feed()` y
+ *     alimenta los decodificadores incrementales (el diccionario LZ78 se conserva entre
+ *     bloques) con la búsqueda KMP del fragmento. Una clave equivocada se descarta en el
+ *     primer bloque (STREAM_PROBE bytes), que se lee una sola vez para todos los candidatos.
+ *  3. El ganador se decodifica otra vez por bloques hacia @p out_path.
+ *
+ * Los candidatos se prueban en el mismo orden (`rank_candidates()`) y con las mismas reglas que
+ * `finder()`, así que el resultado coincide con el de `finder()`.
+ *
+ * @param[in]  enc_path       Ruta del archivo encriptado.
+ * @param[in]  know_fragment  Fragmento de texto conocido.
+ * @param[in]  out_path       Archivo donde se escribe el mensaje.
+ * @param[in]  mem_cap        Memoria máxima para bloques y decodificadores (0 = STREAM_MEM_DEFAULT).
+ *                            Por debajo de ~1 MB se usa el mínimo que necesitan los decodificadores.
+ * @param[out] out_method     Método usado ("RLE" o "LZ78"); liberar con `delete[]`.
+ * @param[out] out_n          Rotación encontrada.
+ * @param[out] out_k          Clave encontrada.
+ * @param[out] out_len        Bytes escritos en @p out_path.
+ *
+ * @return `true` si se encontró la combinación y se escribió el mensaje.
+ */
+bool finder_stream(const char *enc_path, const char *know_fragment, const char *out_path, size_t mem_cap,
+                   char **out_method, uint8_t *out_n, uint8_t *out_k, size_t *out_len);
+
+/**
+ * @brief Búsqueda con una clave XOR de varios bytes que se repite:
+ *        `dec[i] = ror_8(enc[i] ^ key[i % L], n)`, con una sola rotación n.
+ *
+ * Probar 7 × 256^L claves es imposible, pero cada byte de clave solo afecta a sus propias
+ * posiciones, así que se resuelve por separado:
+ *  1. `detect_key_length()` propone las longitudes L plausibles.
+ *  2. Para cada L y cada rotación, cada byte de clave se elige con el histograma de sus
+ *     columnas de símbolos (como `rank_candidates()`): 7 × 256 × L intentos en total.
+ *  3. Las rotaciones se prueban de la más a la menos probable y cada clave se confirma con
+ *     el mismo camino que `finder()` (clasificación, descompresión y pista).
+ *
+ * Si L es múltiplo de 3, los bytes de clave que no cifran símbolos se deducen del formato
+ * (repeticiones cortas en RLE, índices válidos en LZ78; los bits bajos del índice quedan
+ * poco restringidos y se verifican hasta KEY_LZ78_COMBOS combinaciones). El byte que cifra la basura de RLE
+ * no afecta al mensaje, así que la clave reportada puede diferir de la original en esos bytes.
+ * Las claves de un byte (L = 1) quedan para `finder_auto()`.
+ *
+ * @param[in] enc            Puntero al buffer con el texto encriptado.
+ * @param[in] enc_len        Longitud del buffer encriptado.
+ * @param[in] know_fragment  Fragmento de texto conocido que debe aparecer en el mensaje descifrado.
+ * @param[out] out_msg       Puntero de salida que contendrá el mensaje descifrado
+ * @param[out] out_method    Puntero de salida que contendrá el método usado ("RLE" o "LZ78").
+ * @param[out] out_n         Puntero de salida para el valor de rotación `n` encontrado.
+ * @param[out] out_key       Arreglo de KEY_LEN_MAX bytes para la clave encontrada.
+ * @param[out] out_key_len   Longitud de la clave encontrada.
+ *
+ * @return `true` si alguna clave confirma la pista, `false` en caso contrario.
+ */
+bool finder_multikey(const uint8_t *enc, size_t enc_len, const char *know_fragment,
+                     char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_key, size_t *out_key_len);
+
+
+// ====== Cifrado (generación de corpus de prueba) ============
+
+/**
+ * @brief Encripta un buffer: rota cada byte @p n posiciones a la izquierda y luego aplica XOR con @p k.
+ *
+ * Es la inversa exacta de `decrypt_buffer()`; se usa para generar corpus de prueba con claves conocidas.
+ *
+ * @param in   Puntero al buffer en claro.
+ * @param len  Longitud en bytes del buffer.
+ * @param n    Número de bits a rotar hacia la izquierda en cada byte (1 a 7).
+ * @param k    Valor de la clave utilizada en la operación XOR.
+ *
+ * @return Puntero a un nuevo buffer dinámico con los datos encriptados (liberar con `delete[]`).
+ */
+uint8_t *encrypt_buffer(const uint8_t *in, size_t len, uint8_t n, uint8_t k);
+
+/**
+ * @brief Encripta con una clave de varios bytes: `enc[i] = rol_8(in[i], n) ^ key[i % key_len]`.
+ *
+ * Es la inversa de `decrypt_into_key()`; se usa para generar corpus de prueba.
+ *
+ * @param in       Puntero al buffer en claro.
+ * @param len      Longitud en bytes del buffer.
+ * @param n        Número de bits a rotar hacia la izquierda en cada byte (1 a 7).
+ * @param key      Clave de @p key_len bytes.
+ * @param key_len  Longitud de la clave.
+ *
+ * @return Puntero a un nuevo buffer dinámico con los datos encriptados (liberar con `delete[]`).
+ */
+uint8_t *encrypt_buffer_key(const uint8_t *in, size_t len, uint8_t n, const uint8_t *key, size_t key_len);
 
 #endif //SOLVER_HPP
@@ -0,0 +1,141 @@
+/**
+ * @file solver_internal.hpp
+ * @brief Etapas internas de la búsqueda, expuestas solo para el solver y los benchmarks
+ *
+ * Este modulo contiene:
+ * decrypt_buffer: Desencriptado a un buffer nuevo
+ * byte_histogram / symbol_histogram: Histogramas del texto cifrado
+ * printable_ratio: Proporción de imprimibles de un candidato a partir del histograma
+ * prefilter_candidates / prefilter_from_histogram: Etapa de prefiltrado
+ * rank_candidates: Orden de los candidatos del más al menos probable
+ * detect_key_length: Longitudes plausibles de una clave de varios bytes
+ *
+ * No forma parte de la interfaz de la aplicación: solo lo incluyen solver.cpp y
+ * bench/bench.cpp. El resto del código usa las funciones `finder*` de solver.hpp.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#ifndef SOLVER_INTERNAL_HPP
+#define SOLVER_INTERNAL_HPP
+
+#include <solver.hpp>
+
+/**
+ * @brief Desencripta un buffer de datos aplicando una operación XOR y una rotación a la derecha.
+ *
+ * Esta función toma un buffer de entrada encriptado, aplica la operación XOR con la clave `k`
+ * y luego rota cada byte `n` posiciones a la derecha, generando un nuevo buffer desencriptado.
+ *
+ * @param in   Puntero al buffer de entrada encriptado.
+ * @param len  Longitud en bytes del buffer de entrada.
+ * @param n    Número de bits a rotar hacia la derecha en cada byte.
+ * @param k    Valor de la clave utilizada en la operación XOR.
+ *
+ * @return Puntero a un nuevo buffer dinámico con los datos desencriptados.
+ *         El usuario es responsable de liberar la memoria con `delete[]`.
+ *
+ * @note La función utiliza `new[]` para reservar memoria.
+ *       Asegúrese de liberar el buffer resultante para evitar fugas de memoria.
+ *
+ * @note La transformación la hace `decrypt_into()`, que usa la versión SSE2/AVX2/AVX-512
+ *       más ancha que soporte la CPU (ver kernels.hpp).
+ */
+uint8_t *decrypt_buffer(const uint8_t *in, size_t len, uint8_t n, uint8_t k);
+
+/**
+ * @brief Construye el histograma de bytes de un buffer.
+ *
+ * @param[in]  buf   Puntero al buffer a analizar.
+ * @param[in]  len   Longitud del buffer en bytes.
+ * @param[out] hist  Arreglo de 256 contadores, uno por valor de byte.
+ */
+void byte_histogram(const uint8_t *buf, size_t len, size_t hist[256]);
+
+/**
+ * @brief Evalúa si la combinación (n, k) produce una proporción suficiente de caracteres ASCII imprimibles.
+ *
+ * Cada byte cifrado se transforma siempre en el mismo byte descifrado, así que la cantidad de
+ * imprimibles (rango ASCII 32–126) se obtiene sumando el histograma del texto cifrado sobre los
+ * valores que descifran a un imprimible. El costo es constante sin importar el tamaño del archivo.
+ *
+ * @param hist       Histograma de 256 bins del texto cifrado.
+ * @param len        Longitud del texto cifrado en bytes.
+ * @param n          Rotación a evaluar.
+ * @param k          Clave XOR a evaluar.
+ * @param min_ratio  Proporción mínima aceptada (entre 0.0 y 1.0).
+ *
+ * @return `true` si el texto descifrado cumpliría con la proporción mínima de caracteres imprimibles,
+ *         `false` en caso contrario o si `len` es cero.
+ */
+bool printable_ratio(const size_t hist[256], size_t len, uint8_t n, uint8_t k, double min_ratio);
+
+/**
+ * @brief Etapa de prefiltrado: puntúa las N_CANDIDATES combinaciones con una sola pasada sobre @p enc.
+ *
+ * @param[in]  enc       Buffer encriptado.
+ * @param[in]  enc_len   Longitud del buffer encriptado.
+ * @param[out] out_cands Arreglo de N_CANDIDATES posiciones donde se escriben, en orden serial,
+ *                       los índices c = (n - ROT_MIN) * KEY_SPACE + k que superan RATIO_MIN.
+ *
+ * @return Cantidad de candidatos escritos en @p out_cands.
+ */
+size_t prefilter_candidates(const uint8_t *enc, size_t enc_len, uint16_t *out_cands);
+
+/**
+ * @brief Igual que `prefilter_candidates()` a partir de un histograma ya construido.
+ *
+ * @param[in]  hist      Histograma de 256 bins del texto cifrado.
+ * @param[in]  enc_len   Longitud del texto cifrado.
+ * @param[out] out_cands Arreglo de N_CANDIDATES posiciones (ver `prefilter_candidates()`).
+ *
+ * @return Cantidad de candidatos escritos en @p out_cands.
+ */
+size_t prefilter_from_histogram(const size_t hist[256], size_t enc_len, uint16_t *out_cands);
+
+/**
+ * @brief Histograma de la columna de símbolos: el tercer byte de cada triple (RLE y LZ78).
+ *
+ * @param[in]  buf       Buffer encriptado (empieza en un límite de triple).
+ * @param[in]  len       Longitud del buffer.
+ * @param[out] sym_hist  Histograma de 256 bins.
+ */
+void symbol_histogram(const uint8_t *buf, size_t len, size_t sym_hist[256]);
+
+/**
+ * @brief Ordena los candidatos del más al menos probable.
+ *
+ * Cada (n, k) se puntúa desencriptando el histograma de la columna de símbolos (no el
+ * texto) contra las frecuencias esperadas de un texto en español: espacio y vocales suman
+ * mucho, los caracteres de control restan. El orden es estable, así que el resultado de
+ * la búsqueda es determinista; con la clave correcta el texto suele quedar primero y la
+ * búsqueda termina en pocos intentos aunque (n, k) esté al final del recorrido serial.
+ *
+ * @param[in]     sym_hist  Histograma de `symbol_histogram()`.
+ * @param[in,out] cands     Índices de candidato (por ejemplo, los del prefiltro).
+ * @param[in]     n_cands   Cantidad de candidatos.
+ */
+void rank_candidates(const size_t sym_hist[256], uint16_t *cands, size_t n_cands);
+
+/**
+ * @brief Propone longitudes de clave a partir del texto cifrado.
+ *
+ * Para cada L de 1 a KEY_LEN_MAX se separan los primeros KEY_LEN_SAMPLE bytes en
+ * `mcm(L, 3)` columnas (así cada columna tiene un solo byte de clave y un solo papel dentro
+ * del triple) y se mide su índice de coincidencia: la XOR con un byte fijo no lo cambia,
+ * pero mezclar bytes de clave distintos lo baja. Se aceptan las L cuyo índice llega a
+ * KEY_LEN_IC_RATIO del mejor; la longitud real y sus múltiplos quedan entre ellas.
+ *
+ * @param[in]  enc       Buffer encriptado.
+ * @param[in]  enc_len   Longitud del buffer.
+ * @param[out] out_lens  Arreglo de KEY_LEN_MAX posiciones; longitudes plausibles de menor a mayor.
+ *
+ * @return Cantidad de longitudes escritas.
+ */
+size_t detect_key_length(const uint8_t *enc, size_t enc_len, size_t *out_lens);
+
+#endif // SOLVER_INTERNAL_HPP
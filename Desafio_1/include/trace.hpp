@@ -0,0 +1,129 @@
+/**
+ * @file trace.hpp
+ * @brief Archivo de cabecera para la instrumentación por etapas del solver
+ *
+ * Este modulo contiene:
+ * trace_stage_t: Etapas medidas (prefiltro, desencriptado, búsquedas, expansiones...)
+ * TRACE_BEGIN / TRACE_END: Macros que miden una etapa en el camino caliente
+ * trace_reset: Pone a cero los contadores
+ * trace_events_enable: Activa el registro de eventos para la traza
+ * trace_print_summary: Resumen por etapa al final de la ejecución
+ * trace_write_chrome: Exporta los eventos en formato Chrome trace-event (JSON)
+ *
+ * La instrumentación solo se compila con `DESAFIO_TRACE` definido (qmake: `CONFIG+=trace`).
+ * Sin esa macro `TRACE_BEGIN` y `TRACE_END` no generan código y los contadores quedan en cero.
+ * Con ella, cada etapa suma llamadas, rechazos, bytes y nanosegundos en contadores atómicos
+ * y, si se activaron los eventos, deja un evento por llamada para verlo en
+ * `chrome://tracing` o Perfetto.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+/**
+ * @enum trace_stage_t
+ * @brief Etapas medidas de la búsqueda.
+ */
+typedef enum {
+    TRACE_FINDER,       /**< Una búsqueda completa (finder, finder_parallel o finder_known_plaintext). */
+    TRACE_PREFILTER,    /**< Histograma + porcentaje de imprimibles; rechazos = candidatos descartados. */
+    TRACE_DECRYPT,      /**< Desencriptado de un candidato. */
+    TRACE_CLASSIFY,     /**< Validación estructural; rechazos = flujos que no son RLE ni LZ78. */
+    TRACE_RLE_MATCH,    /**< Búsqueda del fragmento sobre los triples RLE. */
+    TRACE_RLE_EXPAND,   /**< Expansión RLE completa del ganador. */
+    TRACE_LZ78_STREAM,  /**< Decodificación LZ78 incremental; rechazos = índice inválido. */
+    TRACE_LZ78_EXPAND,  /**< Descompresión LZ78 completa del ganador. */
+    TRACE_VERIFY,       /**< Verificación final del fragmento sobre el mensaje. */
+    TRACE_N_STAGES
+} trace_stage_t;
+
+/**
+ * @struct trace_stats_t
+ * @brief Contadores acumulados de una etapa.
+ */
+typedef struct {
+    uint64_t calls;     /**< Veces que se ejecutó la etapa. */
+    uint64_t rejected;  /**< Candidatos descartados en la etapa. */
+    uint64_t bytes;     /**< Bytes procesados o producidos. */
+    uint64_t ns;        /**< Tiempo total en nanosegundos. */
+} trace_stats_t;
+
+#ifdef DESAFIO_TRACE
+#define TRACE_BEGIN(t0) uint64_t t0 = trace_now_ns()
+#define TRACE_END(stage, t0, bytes, rejected) trace_record((stage), (t0), (uint64_t)(bytes), (uint64_t)(rejected))
+#else
+#define TRACE_BEGIN(t0) do {} while (0)
+#define TRACE_END(stage, t0, bytes, rejected) do {} while (0)
+#endif
+
+/**
+ * @brief Indica si el binario se compiló con la instrumentación.
+ */
+bool trace_compiled();
+
+/**
+ * @brief Reloj monótono en nanosegundos.
+ */
+uint64_t trace_now_ns();
+
+/**
+ * @brief Suma una llamada a los contadores de @p stage y, si están activos, registra un evento.
+ *
+ * Se usa a través de `TRACE_END`.
+ *
+ * @param stage     Etapa medida.
+ * @param t0        Inicio de la etapa (`trace_now_ns()`).
+ * @param bytes     Bytes procesados o producidos.
+ * @param rejected  Candidatos descartados en esta llamada.
+ */
+void trace_record(trace_stage_t stage, uint64_t t0, uint64_t bytes, uint64_t rejected);
+
+/**
+ * @brief Pone a cero los contadores y descarta los eventos registrados.
+ */
+void trace_reset();
+
+/**
+ * @brief Reserva espacio para @p capacity eventos y empieza a registrarlos.
+ *
+ * Los eventos que no caben se cuentan como descartados.
+ */
+void trace_events_enable(size_t capacity);
+
+/**
+ * @brief Copia los contadores acumulados de @p stage.
+ */
+trace_stats_t trace_stats(trace_stage_t stage);
+
+/**
+ * @brief Nombre de una etapa ("decrypt", "rle_match"...).
+ */
+const char *trace_stage_name(trace_stage_t stage);
+
+/**
+ * @brief Escribe una tabla con los contadores de cada etapa.
+ *
+ * @param out  Destino (normalmente `stderr`).
+ */
+void trace_print_summary(FILE *out);
+
+/**
+ * @brief Exporta los eventos registrados en formato Chrome trace-event.
+ *
+ * @param path  Archivo JSON de destino.
+ *
+ * @return `true` si se pudo escribir el archivo.
+ */
+bool trace_write_chrome(const char *path);
+
+#endif // TRACE_HPP
@@ -3,7 +3,11 @@
  * @brief Implementación de las funciones principales de la aplicación.
  *
  * Este archivo contiene la lógica principal (`app_main`) y funciones auxiliares
- * para leer archivos y extraer fragmentos de texto.
+ * para leer archivos y extraer fragmentos de texto. La lectura se apoya en la
+ * capa de mapeo de memoria de @ref input.hpp.
+ *
+ * En el modo interactivo la lectura, la búsqueda y la impresión van en etapas separadas
+ * (`reader_stage`, `solver_stage`, `print_slot`) unidas por un anillo de pares en vuelo.
  * 
  * @authors Julián Sánchez
  *          Jaider Bedoya
@@ -13,65 +17,238 @@
  */
 
 #include <app.hpp>
+#include <batch.hpp>
+#ifdef DESAFIO_DAEMON
+#include <daemon.hpp>
+#endif
+#include <keycache.hpp>
+#include <output.hpp>
+
+#include <condition_variable>
+#include <cstdlib>
 
 namespace
 {
     /**
-     * @brief Obtiene el tamaño de un archivo en bytes.
-     *
-     * Abre el archivo en modo binario, mueve el puntero al final,
-     * consulta su posición (que corresponde al tamaño), y vuelve
-     * al inicio antes de cerrar.
+     * @enum slot_state_t
+     * @brief Etapa en la que está un par dentro del pipeline.
+     */
+    typedef enum {
+        SLOT_FREE,      /**< Libre: el lector puede abrir el siguiente par. */
+        SLOT_READ,      /**< Archivos abiertos y en memoria, esperando un trabajador. */
+        SLOT_SOLVING,   /**< Un trabajador lo está resolviendo. */
+        SLOT_DONE       /**< Resultado listo para imprimir. */
+    } slot_state_t;
+
+    /**
+     * @struct pair_slot_t
+     * @brief Un par en vuelo: archivos abiertos y, al final, su resultado.
+     */
+    typedef struct {
+        slot_state_t state;
+        int index;                  /**< Par que ocupa la posición (X). */
+        char enc_name[64];          /**< EncriptadoX.txt */
+        char pista_name[64];        /**< pistaX.txt */
+        input_view_t enc_view;      /**< Texto cifrado (se cierra al resolver). */
+        input_view_t frag_view;     /**< Pista (se cierra al resolver). */
+        bool enc_ok;                /**< Se pudo abrir el encriptado. */
+        bool frag_ok;               /**< Se pudo abrir la pista. */
+        bool found;                 /**< Se encontró la combinación. */
+        char *msg;                  /**< Mensaje recuperado (del solver). */
+        char *method;               /**< "RLE" o "LZ78" (del solver). */
+        uint8_t n;                  /**< Rotación. */
+        uint8_t k;                  /**< Clave de un byte. */
+        uint8_t key[KEY_LEN_MAX];   /**< Clave de varios bytes (si key_len > 1). */
+        size_t key_len;             /**< Bytes de la clave. */
+    } pair_slot_t;
+
+    /**
+     * @struct pipeline_t
+     * @brief Estado compartido por las tres etapas.
      *
-     * @param[in] path Ruta al archivo.
-     * @return Tamaño del archivo en bytes o NO_SIZE si ocurre un error.
+     * El par i ocupa la posición `i % window` del anillo. Los lectores no abren el par i
+     * hasta que se imprimió el par `i - window`, así que nunca hay más de `window` pares
+     * abiertos o con el mensaje en memoria, aunque terminen en desorden.
      */
-    size_t get_file_size(const char *path)
-    {
-        // Abrir fichero en modo binario
-        FILE *f = fopen(path, "rb");
+    typedef struct {
+        int n_pairs;                /**< Pares a procesar (1..n_pairs). */
+        unsigned int n_workers;     /**< Trabajadores. */
+        unsigned int solve_threads; /**< Hilos de la fuerza bruta por trabajador. */
+        size_t window;              /**< Tamaño del anillo. */
+        pair_slot_t *slots;         /**< Anillo de pares en vuelo. */
+        int next_read;              /**< Siguiente par a abrir. */
+        int next_solve;             /**< Siguiente par a resolver. */
+        int printed;                /**< Último par impreso. */
+        keycache_t *cache;          /**< Caché de claves compartida. */
+        mutex lock;
+        condition_variable changed; /**< Cualquier cambio de estado de un par. */
+    } pipeline_t;
 
-        if (!f)
+    /**
+     * @brief Etapa de lectura: abre los pares en orden y trae su contenido a memoria.
+     */
+    void reader_stage(pipeline_t *p)
+    {
+        for (;;)
         {
-            fprintf(stderr, "Error: no se pudo abrir el archivo %s\n", path);
-            return NO_SIZE;
+            int i;
+            pair_slot_t *slot;
+            {
+                unique_lock<mutex> guard(p->lock);
+                if (p->next_read > p->n_pairs)
+                {
+                    return;
+                }
+                i = p->next_read++;
+                p->changed.wait(guard, [p, i]() { return (size_t)(i - p->printed) <= p->window; });
+                slot = &p->slots[(size_t)i % p->window];
+            }
+
+            // Genera nombres de archivo dinámicamente: EncriptadoX.txt y pistaX.txt
+            snprintf(slot->enc_name, sizeof(slot->enc_name), "Encriptado%d.txt", i);
+            snprintf(slot->pista_name, sizeof(slot->pista_name), "pista%d.txt", i);
+
+            // Mapeo sin copias; la lectura del disco se hace aquí y no en el trabajador
+            slot->enc_ok = input_open(slot->enc_name, &slot->enc_view);
+            slot->frag_ok = slot->enc_ok && input_open_text(slot->pista_name, &slot->frag_view);
+            if (slot->frag_ok)
+            {
+                input_prefetch(&slot->enc_view);
+                input_prefetch(&slot->frag_view);
+            }
+            else if (slot->enc_ok)
+            {
+                input_close(&slot->enc_view);
+            }
+
+            lock_guard<mutex> guard(p->lock);
+            slot->index = i;
+            slot->state = SLOT_READ;
+            p->changed.notify_all();
         }
+    }
 
-        // Posicionar puntero al final del archivo
-        if (fseek(f, 0, SEEK_END) != 0)
+    /**
+     * @brief Etapa de resolución: toma los pares en orden a medida que están leídos.
+     */
+    void solver_stage(pipeline_t *p)
+    {
+        for (;;)
         {
-            fprintf(stderr, "Error: fallo al mover el puntero al final del archivo\n");
-            fclose(f);
-            return NO_SIZE;
+            pair_slot_t *slot;
+            {
+                unique_lock<mutex> guard(p->lock);
+                if (p->next_solve > p->n_pairs)
+                {
+                    return;
+                }
+                int i = p->next_solve++;
+                slot = &p->slots[(size_t)i % p->window];
+                p->changed.wait(guard, [slot, i]() { return slot->state == SLOT_READ && slot->index == i; });
+                slot->state = SLOT_SOLVING;
+            }
+
+            slot->found = false;
+            slot->key_len = 1;
+            if (slot->frag_ok)
+            {
+                const uint8_t *enc = slot->enc_view.data;
+                size_t enc_len = slot->enc_view.len;
+                const char *frag = input_cstr(&slot->frag_view);
+
+                // Buscar coincidencia con la pista: primero las claves de la caché, luego los pocos
+                // candidatos que deja el texto conocido y, si ninguno sirve, fuerza bruta
+                slot->found = finder_cached(p->cache, enc, enc_len, frag, &slot->msg, &slot->method,
+                                            &slot->n, &slot->k, p->solve_threads);
+
+                // Ninguna clave de un byte sirve: clave de varios bytes que se repite
+                if (!slot->found)
+                {
+                    slot->found = finder_multikey(enc, enc_len, frag, &slot->msg, &slot->method,
+                                                  &slot->n, slot->key, &slot->key_len);
+                }
+
+                // Liberar los mapeos apenas se resuelve el par
+                input_close(&slot->enc_view);
+                input_close(&slot->frag_view);
+            }
+
+            lock_guard<mutex> guard(p->lock);
+            slot->state = SLOT_DONE;
+            p->changed.notify_all();
         }
+    }
 
-        // ftell devuelve la posición actual del puntero
-        long sz = ftell(f);
-
-        if (sz < 0)
+    /**
+     * @brief Etapa de salida: imprime el resultado de un par y libera su mensaje.
+     */
+    void print_slot(pair_slot_t *slot)
+    {
+        // Diagnósticos por la salida de error: la salida estándar queda solo con resultados
+        if (!slot->enc_ok)
         {
-            fprintf(stderr, "Error: fallo al obtener el tamaño del archivo\n");
-            fclose(f);
-            return NO_SIZE;
+            fprintf(stderr, "No se pudo leer: %s\n", slot->enc_name);
+            return;
         }
-
-        // Reposicionar puntero al inicio para próximas lecturas
-        if (fseek(f, 0, SEEK_SET) != 0)
+        if (!slot->frag_ok)
         {
-            fprintf(stderr, "Error: fallo al reposicionar el puntero al inicio\n");
-            fclose(f);
-            return NO_SIZE;
+            fprintf(stderr, "No se pudo leer: %s\n", slot->pista_name);
+            return;
         }
 
-        fclose(f);
-        return static_cast<size_t>(sz); // Conversión explícita a size_t
-    }
+        cout << "\n\n** " << slot->enc_name << " **\n";
+
+        if (slot->found) {
+            // Imprimir resultados de la búsqueda
+            cout << "Compresión: " << slot->method << "\n";
+            cout << "Rotación: " << (int)slot->n << "\n";
+            if (slot->key_len > 1) {
+                printf("Clave (%zu bytes):", slot->key_len);
+                for (size_t i = 0; i < slot->key_len; i++) {
+                    printf(" 0x%02X", slot->key[i]);
+                }
+                printf("\n");
+            } else {
+                printf("k: 0x%02X\n", slot->k);
+            }
+            // El mensaje va directo del buffer del solver a la salida, sin copias por iostreams
+            char label[] = "Mensaje: \n\n";
+            char eol[] = "\n";
+            output_iov_t iov[3] = {{label, strlen(label)}, {slot->msg, strlen(slot->msg)}, {eol, 1}};
+            output_stdout(iov, 3);
 
-}; // namespace
+            // Liberar memoria reservada por solver
+            delete[] slot->msg;
+            delete[] slot->method;
 
+        } else {
+            cout << "No se encontró coincidencia con la pista.\n";
+        }
+    }
 
-my_error_t app_main()
+}
+
+my_error_t app_main(int argc, char **argv)
 {
+    // Con argumentos: modo por bloques, demonio o por lotes, sin preguntas por la entrada estándar
+    if (argc > 1 && strcmp(argv[1], "--stream") == 0)
+    {
+        return stream_main(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--daemon") == 0)
+    {
+#ifdef DESAFIO_DAEMON
+        return daemon_main(argc, argv);
+#else
+        fprintf(stderr, "Error: el modo demonio solo está disponible en sistemas POSIX\n");
+        return ERROR;
+#endif
+    }
+    if (argc > 1)
+    {
+        return batch_main(argc, argv);
+    }
+
     int n;
     cout << "Ingrese el numero de archivos para la prueba: ";
     cin >> n;
@@ -82,115 +259,192 @@ my_error_t app_main()
         return ERROR;
     }
 
-    // Procesar n archivos con sus respectivas pistas
-    for (int i = 1; i <= n; i++)
-    {
-        char enc_name[64];
-        char pista_name[64];
+    // Caché de claves en memoria; solo se guarda en disco si se pide con DESAFIO_CACHE
+    keycache_t cache;
+    keycache_load(&cache, getenv(KEYCACHE_ENV) ? keycache_default_path() : nullptr);
 
-        // Genera nombres de archivo dinámicamente: EncriptadoX.txt y pistaX.txt
-        snprintf(enc_name, sizeof(enc_name), "Encriptado%d.txt", i);
-        snprintf(pista_name, sizeof(pista_name), "pista%d.txt", i);
+    // ====== Etapas: lectores -> trabajadores -> impresión en orden ============
+    unsigned int hw = thread::hardware_concurrency();
+    if (hw == 0)
+    {
+        hw = 1;
+    }
 
-        // ====== Lectura del archivo encriptado ============
-        uint8_t *enc = nullptr;
-        size_t enc_len = 0;
+    pipeline_t p;
+    p.n_pairs = n;
+    p.n_workers = hw < (unsigned int)n ? hw : (unsigned int)n;
+    p.solve_threads = hw / p.n_workers; // con un solo archivo, la fuerza bruta usa todos los núcleos
+    p.window = p.n_workers + APP_PREFETCH_DEPTH;
+    p.slots = new pair_slot_t[p.window];
+    for (size_t s = 0; s < p.window; s++)
+    {
+        p.slots[s].state = SLOT_FREE;
+    }
+    p.next_read = 1;
+    p.next_solve = 1;
+    p.printed = 0;
+    p.cache = &cache;
+
+    unsigned int n_readers = APP_READERS < n ? APP_READERS : (unsigned int)n;
+    thread *readers = new thread[n_readers];
+    thread *workers = new thread[p.n_workers];
+    for (unsigned int t = 0; t < n_readers; t++)
+    {
+        readers[t] = thread(reader_stage, &p);
+    }
+    for (unsigned int t = 0; t < p.n_workers; t++)
+    {
+        workers[t] = thread(solver_stage, &p);
+    }
 
-        if (!read_file(enc_name, &enc, &enc_len))
+    // El hilo principal imprime cada archivo apenas está resuelto y en el orden de siempre
+    for (int i = 1; i <= n; i++)
+    {
+        pair_slot_t *slot = &p.slots[(size_t)i % p.window];
         {
-            cout << "No se pudo leer: " << enc_name << endl;
-            continue;
+            unique_lock<mutex> guard(p.lock);
+            p.changed.wait(guard, [slot]() { return slot->state == SLOT_DONE; });
         }
 
-        // ====== Lectura de la pista ============
-        char* frag = get_frag(pista_name);
+        print_slot(slot);
 
-        if (!frag)
-        {
-            cout << "No se pudo leer: " << pista_name << endl;
-            delete[] enc; // Liberar memoria reservada
-            continue;
-        }
+        lock_guard<mutex> guard(p.lock);
+        slot->state = SLOT_FREE;
+        p.printed = i;
+        p.changed.notify_all();
+    }
 
-        cout << "\n\n** " << enc_name << " **\n";
+    for (unsigned int t = 0; t < n_readers; t++)
+    {
+        readers[t].join();
+    }
+    for (unsigned int t = 0; t < p.n_workers; t++)
+    {
+        workers[t].join();
+    }
+    delete[] readers;
+    delete[] workers;
+    delete[] p.slots;
 
-        // Variables de salida del solver
-        char *out_msg = nullptr;
-        char *out_method = nullptr;
-        uint8_t out_n = 0;
-        uint8_t out_k = 0;
+    keycache_free(&cache);
 
-        // Buscar coincidencia con la pista usando el solver
-        bool result = finder(enc, enc_len, frag, &out_msg, &out_method, &out_n, &out_k);
+    // Con la instrumentación compilada: tiempo por etapa de todos los archivos
+    if (trace_compiled())
+    {
+        trace_print_summary(stderr);
+    }
 
-        if (result) {
-            // Imprimir resultados de la búsqueda
-            cout << "Compresión: " << out_method << endl;
-            cout << "Rotación: " << (int)out_n << "\n";
-            printf("k: 0x%02X\n", out_k);
-            cout << "Mensaje: \n\n" << out_msg << endl;
+    return OK;
+}
 
-            // Liberar memoria reservada por solver
-            delete[] out_msg;
-            delete[] out_method;
 
-        } else {
-            cout << "No se encontró coincidencia con la pista.\n";
+my_error_t stream_main(int argc, char **argv)
+{
+    const char *enc_path = nullptr;
+    const char *hint_path = nullptr;
+    const char *out_path = nullptr;
+    size_t mem_cap = 0;
+
+    for (int a = 1; a + 1 < argc; a += 2)
+    {
+        if (strcmp(argv[a], "--stream") == 0)
+        {
+            enc_path = argv[a + 1];
         }
+        else if (strcmp(argv[a], "--hint") == 0)
+        {
+            hint_path = argv[a + 1];
+        }
+        else if (strcmp(argv[a], "-o") == 0)
+        {
+            out_path = argv[a + 1];
+        }
+        else if (strcmp(argv[a], "--mem") == 0)
+        {
+            // Sufijos K, M o G (potencias de 1024)
+            char *end = nullptr;
+            double v = strtod(argv[a + 1], &end);
+            switch (*end)
+            {
+            case 'k': case 'K': v *= 1024.0; break;
+            case 'm': case 'M': v *= 1024.0 * 1024.0; break;
+            case 'g': case 'G': v *= 1024.0 * 1024.0 * 1024.0; break;
+            default: break;
+            }
+            mem_cap = (size_t)v;
+        }
+    }
 
-        // Liberar memoria usada en este ciclo
-        delete[] enc;
-        delete[] frag;
+    if (!enc_path || !hint_path || !out_path)
+    {
+        fprintf(stderr, "Uso: %s --stream <encriptado> --hint <pista> -o <salida> [--mem bytes]\n", argv[0]);
+        return ERROR;
     }
 
-    return OK;
-}
+    input_view_t frag_view;
+    if (!input_open_text(hint_path, &frag_view))
+    {
+        fprintf(stderr, "No se pudo leer: %s\n", hint_path);
+        return ERROR;
+    }
 
+    char *out_method = nullptr;
+    uint8_t out_n = 0;
+    uint8_t out_k = 0;
+    size_t out_len = 0;
 
-my_error_t read_file(const char *path, uint8_t **out_buf, size_t *out_len)
-{
-    size_t sz = get_file_size(path);
-    if (!sz) {
+    bool result = finder_stream(enc_path, input_cstr(&frag_view), out_path, mem_cap,
+                                &out_method, &out_n, &out_k, &out_len);
+    input_close(&frag_view);
+
+    if (!result)
+    {
+        fprintf(stderr, "No se encontró coincidencia con la pista.\n");
         return ERROR;
     }
 
-    FILE *f = fopen(path, "r");
-    if (!f) {
-        cout << "Error: No se pudo abrir el archivo: " << path << "\n";
-        return ERROR;
+    printf("Compresión: %s\nRotación: %d\nk: 0x%02X\nMensaje: %s (%zu bytes)\n",
+           out_method, (int)out_n, out_k, out_path, out_len);
+    delete[] out_method;
+
+    if (trace_compiled())
+    {
+        trace_print_summary(stderr);
     }
+    return OK;
+}
 
-    // Reservar buffer y leer contenido
-    uint8_t *buf = new uint8_t[sz];
-    size_t r = fread(buf, 1, sz, f);
-    fclose(f);
 
-    if (r != sz) {
-        cout << "Error: No se leyó el archivo completo.\n";
-        delete[] buf;
+my_error_t read_file(const char *path, uint8_t **out_buf, size_t *out_len)
+{
+    input_view_t view;
+    if (!input_open(path, &view)) {
         return ERROR;
     }
 
+    // Copia propia para el llamador
+    uint8_t *buf = new uint8_t[view.len];
+    memcpy(buf, view.data, view.len);
+
     *out_buf = buf;
-    *out_len = sz;
+    *out_len = view.len;
+    input_close(&view);
     return OK;
 }
 
 
 char *get_frag(const char *path)
 {
-    uint8_t* buf = nullptr;
-    size_t len = 0;
-
-    if (read_file(path, &buf, &len) != OK) {
+    input_view_t view;
+    if (!input_open_text(path, &view)) {
         return nullptr;
     }
 
     // Crear copia en formato C-string
-    char *frag = new char[len + 1];
-    memcpy(frag, buf, len);
-    frag[len] = '\0';
+    char *frag = new char[view.len + 1];
+    memcpy(frag, view.data, view.len);
+    frag[view.len] = '\0';
 
-    delete[] buf; // liberar el buffer original
+    input_close(&view);
     return frag;
 }
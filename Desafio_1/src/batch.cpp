@@ -0,0 +1,872 @@
+/**
+ * @file batch.cpp
+ * @brief Implementación del modo por lotes (no interactivo)
+ *
+ * Este modulo contiene:
+ *      - batch_main: Lectura de opciones, armado de la lista de pares y grupo de hilos
+ * Ademas cuenta con funciones auxiliares:
+ *      - pairs_from_dir / pairs_from_manifest / pairs_from_glob: Fuentes de pares
+ *      - list_dir / hint_for / path_join: Listado de carpetas y rutas con cadenas de C
+ *      - check_message_names: Descarta colisiones de nombres en `--out-dir`
+ *      - solve_job: Resuelve un par, guarda el mensaje (`--out-dir` / `--archive`) y mide el tiempo
+ *      - write_json_line: Escribe el resultado de un par como JSON
+ *
+ * Con la instrumentación compilada (`CONFIG+=trace`) se imprime al final el resumen por
+ * etapa y `--trace <archivo>` exporta la traza en formato Chrome trace-event.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <batch.hpp>
+#include <output.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+
+namespace
+{
+    /**
+     * @struct job_t
+     * @brief Un par de archivos a resolver y su resultado.
+     */
+    typedef struct {
+        char *enc_path;     /**< Ruta del archivo encriptado. */
+        char *hint_path;    /**< Ruta de la pista. */
+        bool read_ok;       /**< Se pudieron leer ambos archivos. */
+        bool found;         /**< Se encontró la combinación. */
+        bool write_ok;      /**< El mensaje se guardó (o no había que guardarlo). */
+        uint8_t n;          /**< Rotación encontrada. */
+        uint8_t k;          /**< Clave encontrada. */
+        uint8_t key[KEY_LEN_MAX]; /**< Clave de varios bytes (si key_len > 1). */
+        size_t key_len;     /**< Bytes de la clave (1 para las de un byte). */
+        const char *method; /**< "RLE" o "LZ78". */
+        size_t msg_len;     /**< Longitud del mensaje recuperado. */
+        double ms;          /**< Tiempo de lectura + búsqueda + escritura del mensaje en milisegundos. */
+    } job_t;
+
+    /**
+     * @struct job_list_t
+     * @brief Arreglo dinámico de trabajos.
+     */
+    typedef struct {
+        job_t *items;
+        size_t count;
+        size_t cap;
+    } job_list_t;
+
+    /**
+     * @brief Copia una cadena a memoria dinámica (liberar con `delete[]`).
+     */
+    char *dup_str(const char *s)
+    {
+        char *out = new char[strlen(s) + 1];
+        strcpy(out, s);
+        return out;
+    }
+
+    /**
+     * @brief Inicio del último componente de @p path (después del último `/` o `\\`).
+     */
+    const char *base_name(const char *path)
+    {
+        const char *name = path;
+        for (const char *q = path; *q; q++)
+        {
+            if (*q == '/' || *q == '\\')
+            {
+                name = q + 1;
+            }
+        }
+        return name;
+    }
+
+    /**
+     * @brief Une una carpeta y un nombre con `/` (liberar con `delete[]`).
+     */
+    char *path_join(const char *dir, const char *name)
+    {
+        size_t dlen = strlen(dir);
+        bool sep = dlen > 0 && dir[dlen - 1] != '/' && dir[dlen - 1] != '\\';
+        char *out = new char[dlen + sep + strlen(name) + 1];
+        memcpy(out, dir, dlen);
+        if (sep)
+        {
+            out[dlen] = '/';
+        }
+        strcpy(out + dlen + sep, name);
+        return out;
+    }
+
+    /**
+     * @brief Agrega un par a la lista, duplicando las rutas.
+     */
+    void jobs_push(job_list_t *list, const char *enc_path, const char *hint_path)
+    {
+        if (list->count == list->cap)
+        {
+            size_t newcap = list->cap ? list->cap * 2 : 64;
+            job_t *items = new job_t[newcap];
+            for (size_t i = 0; i < list->count; i++)
+            {
+                items[i] = list->items[i];
+            }
+            delete[] list->items;
+            list->items = items;
+            list->cap = newcap;
+        }
+
+        job_t &j = list->items[list->count++];
+        j.enc_path = dup_str(enc_path);
+        j.hint_path = dup_str(hint_path);
+        j.read_ok = false;
+        j.found = false;
+        j.write_ok = true;
+        j.n = 0;
+        j.k = 0;
+        j.key_len = 1;
+        j.method = "";
+        j.msg_len = 0;
+        j.ms = 0;
+    }
+
+    /**
+     * @brief Libera la lista y sus rutas.
+     */
+    void jobs_free(job_list_t *list)
+    {
+        for (size_t i = 0; i < list->count; i++)
+        {
+            delete[] list->items[i].enc_path;
+            delete[] list->items[i].hint_path;
+        }
+        delete[] list->items;
+        list->items = nullptr;
+        list->count = 0;
+        list->cap = 0;
+    }
+
+    /**
+     * @struct name_list_t
+     * @brief Nombres de las entradas de una carpeta.
+     */
+    typedef struct {
+        char **items;
+        size_t count;
+        size_t cap;
+    } name_list_t;
+
+    void names_free(name_list_t *list)
+    {
+        for (size_t i = 0; i < list->count; i++)
+        {
+            delete[] list->items[i];
+        }
+        delete[] list->items;
+        list->items = nullptr;
+        list->count = 0;
+        list->cap = 0;
+    }
+
+    void names_push(name_list_t *list, const char *name)
+    {
+        if (list->count == list->cap)
+        {
+            size_t newcap = list->cap ? list->cap * 2 : 64;
+            char **items = new char *[newcap];
+            for (size_t i = 0; i < list->count; i++)
+            {
+                items[i] = list->items[i];
+            }
+            delete[] list->items;
+            list->items = items;
+            list->cap = newcap;
+        }
+        list->items[list->count++] = dup_str(name);
+    }
+
+    /**
+     * @brief Lista los nombres de las entradas de @p dir (sin `.` ni `..`).
+     *
+     * @return `false` si la carpeta no se pudo abrir.
+     */
+    bool list_dir(const char *dir, name_list_t *out)
+    {
+#ifdef _WIN32
+        char *pattern = path_join(dir, "*");
+        struct _finddata_t fd;
+        intptr_t h = _findfirst(pattern, &fd);
+        delete[] pattern;
+        if (h == -1)
+        {
+            return false;
+        }
+        do
+        {
+            if (strcmp(fd.name, ".") != 0 && strcmp(fd.name, "..") != 0)
+            {
+                names_push(out, fd.name);
+            }
+        } while (_findnext(h, &fd) == 0);
+        _findclose(h);
+#else
+        DIR *d = opendir(dir);
+        if (!d)
+        {
+            return false;
+        }
+        for (struct dirent *e = readdir(d); e; e = readdir(d))
+        {
+            if (strcmp(e->d_name, ".") != 0 && strcmp(e->d_name, "..") != 0)
+            {
+                names_push(out, e->d_name);
+            }
+        }
+        closedir(d);
+#endif
+        return true;
+    }
+
+    /**
+     * @brief Si @p name es `Encriptado<dígitos>.txt`, devuelve el número; si no, -1.
+     *
+     * El número solo ordena los pares: los nombres se usan tal cual, así que
+     * `Encriptado01.txt` y `Encriptado1.txt` son dos pares distintos.
+     */
+    long enc_index(const char *name)
+    {
+        const char *prefix = "Encriptado";
+        size_t plen = strlen(prefix);
+        if (strncmp(name, prefix, plen) != 0)
+        {
+            return -1;
+        }
+
+        const char *digits = name + plen;
+        const char *end = digits;
+        while (*end >= '0' && *end <= '9')
+        {
+            end++;
+        }
+        if (end == digits || end - digits > 9 || strcmp(end, ".txt") != 0)
+        {
+            return -1;
+        }
+        return strtol(digits, nullptr, 10);
+    }
+
+    /**
+     * @brief Deriva la ruta de la pista cambiando el último `Encriptado` del nombre por `pista`.
+     *
+     * @return Ruta en memoria dinámica, o nullptr si el nombre no contiene `Encriptado`.
+     */
+    char *hint_for(const char *enc_path)
+    {
+        const char *name = base_name(enc_path);
+        const char *word = "Encriptado";
+        size_t wlen = strlen(word);
+
+        const char *pos = nullptr;
+        for (const char *q = strstr(name, word); q; q = strstr(q + 1, word))
+        {
+            pos = q;
+        }
+        if (!pos)
+        {
+            return nullptr;
+        }
+
+        size_t head = (size_t)(pos - enc_path);
+        const char *tail = pos + wlen;
+        char *out = new char[head + strlen("pista") + strlen(tail) + 1];
+        memcpy(out, enc_path, head);
+        strcpy(out + head, "pista");
+        strcat(out + head, tail);
+        return out;
+    }
+
+    /**
+     * @brief Agrega un par por ruta de encriptado; la pista se deriva con `hint_for()`.
+     */
+    void jobs_push_enc(job_list_t *jobs, const char *enc_path)
+    {
+        char *hint = hint_for(enc_path);
+        if (!hint)
+        {
+            fprintf(stderr, "Aviso: %s no tiene una pista asociada\n", enc_path);
+            return;
+        }
+        jobs_push(jobs, enc_path, hint);
+        delete[] hint;
+    }
+
+    /**
+     * @brief Agrega cada `EncriptadoN.txt` de @p dir con su `pistaN.txt`, ordenados por N.
+     */
+    bool pairs_from_dir(const char *dir, job_list_t *jobs)
+    {
+        name_list_t names = {nullptr, 0, 0};
+        if (!list_dir(dir, &names))
+        {
+            fprintf(stderr, "Error: no se pudo abrir la carpeta %s\n", dir);
+            return false;
+        }
+
+        // Solo los nombres con el formato; el resto se descarta
+        size_t count = 0;
+        for (size_t i = 0; i < names.count; i++)
+        {
+            if (enc_index(names.items[i]) >= 0)
+            {
+                names.items[count++] = names.items[i];
+            }
+            else
+            {
+                delete[] names.items[i];
+            }
+        }
+        names.count = count;
+
+        // Inserción por número y, a igual número (`1` y `01`), por nombre: salida estable
+        for (size_t a = 1; a < count; a++)
+        {
+            char *v = names.items[a];
+            long iv = enc_index(v);
+            size_t b = a;
+            for (; b > 0; b--)
+            {
+                long ib = enc_index(names.items[b - 1]);
+                if (ib < iv || (ib == iv && strcmp(names.items[b - 1], v) <= 0))
+                {
+                    break;
+                }
+                names.items[b] = names.items[b - 1];
+            }
+            names.items[b] = v;
+        }
+
+        for (size_t a = 0; a < count; a++)
+        {
+            char *enc_path = path_join(dir, names.items[a]);
+            jobs_push_enc(jobs, enc_path);
+            delete[] enc_path;
+        }
+
+        names_free(&names);
+        return true;
+    }
+
+    /**
+     * @brief Agrega los pares de un manifiesto: `<encriptado> <pista>` por línea.
+     */
+    bool pairs_from_manifest(const char *path, job_list_t *jobs)
+    {
+        FILE *f = fopen(path, "r");
+        if (!f)
+        {
+            fprintf(stderr, "Error: no se pudo abrir el manifiesto %s\n", path);
+            return false;
+        }
+
+        char line[4096];
+        while (fgets(line, sizeof(line), f))
+        {
+            char enc_path[2048];
+            char hint_path[2048];
+            if (line[0] == '#' || sscanf(line, "%2047s %2047s", enc_path, hint_path) != 2)
+            {
+                continue; // comentario o línea incompleta
+            }
+            jobs_push(jobs, enc_path, hint_path);
+        }
+
+        fclose(f);
+        return true;
+    }
+
+    /**
+     * @brief Compara un nombre con un patrón con comodines `*` y `?`.
+     */
+    bool wildcard_match(const char *pat, const char *s)
+    {
+        const char *star = nullptr;
+        const char *retry = nullptr;
+        while (*s)
+        {
+            if (*pat == '?' || *pat == *s)
+            {
+                pat++;
+                s++;
+            }
+            else if (*pat == '*')
+            {
+                star = pat++;
+                retry = s;
+            }
+            else if (star)
+            {
+                pat = star + 1;
+                s = ++retry;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        while (*pat == '*')
+        {
+            pat++;
+        }
+        return *pat == '\0';
+    }
+
+    /**
+     * @brief Agrega los archivos encriptados que cumplen el patrón (comodines en el nombre).
+     */
+    bool pairs_from_glob(const char *pattern, job_list_t *jobs)
+    {
+        // Carpeta y patrón del nombre
+        const char *name_pat = base_name(pattern);
+        char *dir;
+        if (name_pat == pattern)
+        {
+            dir = dup_str(".");
+        }
+        else
+        {
+            size_t dlen = (size_t)(name_pat - pattern);
+            dir = new char[dlen + 1];
+            memcpy(dir, pattern, dlen);
+            dir[dlen] = '\0';
+        }
+
+        name_list_t names = {nullptr, 0, 0};
+        if (!list_dir(dir, &names))
+        {
+            fprintf(stderr, "Error: no se pudo abrir la carpeta %s\n", dir);
+            delete[] dir;
+            return false;
+        }
+
+        // Orden alfabético para que la lista sea estable
+        for (size_t a = 1; a < names.count; a++)
+        {
+            char *v = names.items[a];
+            size_t b = a;
+            for (; b > 0 && strcmp(names.items[b - 1], v) > 0; b--)
+            {
+                names.items[b] = names.items[b - 1];
+            }
+            names.items[b] = v;
+        }
+
+        for (size_t a = 0; a < names.count; a++)
+        {
+            if (!wildcard_match(name_pat, names.items[a]))
+            {
+                continue;
+            }
+            // Sin carpeta en el patrón, la ruta queda relativa como la escribió el usuario
+            char *enc_path = name_pat == pattern ? dup_str(names.items[a]) : path_join(dir, names.items[a]);
+            jobs_push_enc(jobs, enc_path);
+            delete[] enc_path;
+        }
+
+        names_free(&names);
+        delete[] dir;
+        return true;
+    }
+
+    /**
+     * @brief Lee y resuelve un par, guardando el resultado en el propio trabajo.
+     *
+     * @param job    Par a resolver.
+     * @param cache  Caché de claves compartida por los hilos.
+     * @param sink   Destino del mensaje (se escribe directo desde el buffer del solver).
+     * @param solve_threads  Hilos de la fuerza bruta de este par.
+     */
+    void solve_job(job_t *job, keycache_t *cache, output_t *sink, unsigned int solve_threads)
+    {
+        auto t0 = chrono::steady_clock::now();
+
+        input_view_t enc_view;
+        input_view_t frag_view;
+
+        if (input_open(job->enc_path, &enc_view))
+        {
+            if (input_open_text(job->hint_path, &frag_view))
+            {
+                job->read_ok = true;
+
+                char *out_msg = nullptr;
+                char *out_method = nullptr;
+
+                // El paralelismo está entre pares; con menos pares que hilos, la fuerza bruta
+                // de cada par usa los que sobran
+                job->found = finder_cached(cache, enc_view.data, enc_view.len, input_cstr(&frag_view),
+                                           &out_msg, &out_method, &job->n, &job->k, solve_threads);
+
+                // Ninguna clave de un byte sirve: clave de varios bytes que se repite
+                if (!job->found)
+                {
+                    job->found = finder_multikey(enc_view.data, enc_view.len, input_cstr(&frag_view),
+                                                 &out_msg, &out_method, &job->n, job->key, &job->key_len);
+                    job->k = job->key[0];
+                }
+                if (job->found)
+                {
+                    job->method = strcmp(out_method, "RLE") == 0 ? "RLE" : "LZ78";
+                    job->msg_len = strlen(out_msg);
+                    job->write_ok = output_message(sink, job->enc_path, out_msg, job->msg_len);
+                    delete[] out_msg;
+                    delete[] out_method;
+                }
+                input_close(&frag_view);
+            }
+            input_close(&enc_view);
+        }
+
+        job->ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+
+    /**
+     * @brief Escribe una cadena JSON escapada.
+     */
+    void write_json_str(FILE *out, const char *s)
+    {
+        fputc('"', out);
+        for (; *s; s++)
+        {
+            unsigned char c = (unsigned char)*s;
+            if (c == '"' || c == '\\')
+            {
+                fputc('\\', out);
+                fputc(c, out);
+            }
+            else if (c < 0x20)
+            {
+                fprintf(out, "\\u%04x", c);
+            }
+            else
+            {
+                fputc(c, out);
+            }
+        }
+        fputc('"', out);
+    }
+
+    /**
+     * @brief Escribe el resultado de un trabajo como una línea JSON.
+     */
+    void write_json_line(FILE *out, const job_t *job)
+    {
+        fputs("{\"enc\":", out);
+        write_json_str(out, job->enc_path);
+        fputs(",\"hint\":", out);
+        write_json_str(out, job->hint_path);
+
+        if (!job->read_ok)
+        {
+            fprintf(out, ",\"found\":false,\"error\":\"no se pudo leer\",\"ms\":%.3f}\n", job->ms);
+        }
+        else if (!job->found)
+        {
+            fprintf(out, ",\"found\":false,\"ms\":%.3f}\n", job->ms);
+        }
+        else if (job->key_len > 1)
+        {
+            fprintf(out, ",\"found\":true,\"n\":%u,\"key\":\"", (unsigned)job->n);
+            for (size_t i = 0; i < job->key_len; i++)
+            {
+                fprintf(out, "%02x", job->key[i]);
+            }
+            fprintf(out, "\",\"method\":\"%s\",\"len\":%zu", job->method, job->msg_len);
+        }
+        else
+        {
+            fprintf(out, ",\"found\":true,\"n\":%u,\"k\":%u,\"method\":\"%s\",\"len\":%zu",
+                    (unsigned)job->n, (unsigned)job->k, job->method, job->msg_len);
+        }
+
+        if (job->read_ok && job->found)
+        {
+            if (!job->write_ok)
+            {
+                fputs(",\"error\":\"no se pudo escribir el mensaje\"", out);
+            }
+            fprintf(out, ",\"ms\":%.3f}\n", job->ms);
+        }
+    }
+
+    /**
+     * @brief Verifica que dos pares no escriban el mismo archivo en la carpeta de mensajes.
+     *
+     * `a/Encriptado1.txt` y `b/Encriptado1.txt` darían los dos `mensaje1.txt`; como los
+     * pares se resuelven en paralelo, el que queda en disco dependería del orden de
+     * terminación. Se reportan todas las colisiones antes de empezar.
+     *
+     * @return `false` si hay alguna colisión.
+     */
+    bool check_message_names(const job_list_t *jobs)
+    {
+        char **names = new char *[jobs->count];
+        size_t *order = new size_t[jobs->count];
+        for (size_t i = 0; i < jobs->count; i++)
+        {
+            names[i] = output_message_name(jobs->items[i].enc_path);
+            order[i] = i;
+        }
+        sort(order, order + jobs->count, [names](size_t a, size_t b) {
+            int c = strcmp(names[a], names[b]);
+            return c < 0 || (c == 0 && a < b);
+        });
+
+        bool ok = true;
+        for (size_t i = 1; i < jobs->count; i++)
+        {
+            if (strcmp(names[order[i - 1]], names[order[i]]) == 0)
+            {
+                fprintf(stderr, "Error: %s y %s escribirían el mismo mensaje %s\n",
+                        jobs->items[order[i - 1]].enc_path, jobs->items[order[i]].enc_path, names[order[i]]);
+                ok = false;
+            }
+        }
+
+        for (size_t i = 0; i < jobs->count; i++)
+        {
+            delete[] names[i];
+        }
+        delete[] names;
+        delete[] order;
+        return ok;
+    }
+
+    /**
+     * @brief Imprime el uso del modo por lotes.
+     */
+    void print_usage(const char *prog)
+    {
+        fprintf(stderr,
+                "Uso: %s (--dir <carpeta> | --manifest <archivo> | --glob <patron>) [-j hilos] [-o salida.jsonl]"
+                " [--out-dir carpeta | --archive mensajes.bin] [--cache claves|none] [--trace traza.json]\n",
+                prog);
+    }
+
+}
+
+my_error_t batch_main(int argc, char **argv)
+{
+    job_list_t jobs = {nullptr, 0, 0};
+    unsigned int n_threads = 0;
+    const char *out_path = nullptr;
+    const char *msg_dir = nullptr;
+    const char *archive_path = nullptr;
+    const char *trace_path = nullptr;
+    const char *cache_path = keycache_default_path();
+    bool have_source = false;
+
+    for (int a = 1; a < argc; a++)
+    {
+        const char *opt = argv[a];
+        const char *val = (a + 1 < argc) ? argv[a + 1] : nullptr;
+
+        if (!val)
+        {
+            print_usage(argv[0]);
+            jobs_free(&jobs);
+            return ERROR;
+        }
+
+        bool ok = true;
+        if (strcmp(opt, "--dir") == 0)
+        {
+            ok = pairs_from_dir(val, &jobs);
+            have_source = true;
+        }
+        else if (strcmp(opt, "--manifest") == 0)
+        {
+            ok = pairs_from_manifest(val, &jobs);
+            have_source = true;
+        }
+        else if (strcmp(opt, "--glob") == 0)
+        {
+            ok = pairs_from_glob(val, &jobs);
+            have_source = true;
+        }
+        else if (strcmp(opt, "-j") == 0)
+        {
+            n_threads = (unsigned int)strtoul(val, nullptr, 10);
+        }
+        else if (strcmp(opt, "-o") == 0)
+        {
+            out_path = val;
+        }
+        else if (strcmp(opt, "--out-dir") == 0)
+        {
+            msg_dir = val;
+        }
+        else if (strcmp(opt, "--archive") == 0)
+        {
+            archive_path = val;
+        }
+        else if (strcmp(opt, "--cache") == 0)
+        {
+            cache_path = strcmp(val, "none") == 0 ? nullptr : val;
+        }
+        else if (strcmp(opt, "--trace") == 0)
+        {
+            trace_path = val;
+        }
+        else
+        {
+            ok = false;
+            print_usage(argv[0]);
+        }
+
+        if (!ok)
+        {
+            jobs_free(&jobs);
+            return ERROR;
+        }
+        a++; // se consumió el valor
+    }
+
+    if (!have_source || jobs.count == 0)
+    {
+        if (!have_source)
+        {
+            print_usage(argv[0]);
+        }
+        else
+        {
+            fprintf(stderr, "Error: no se encontraron pares para procesar\n");
+        }
+        jobs_free(&jobs);
+        return ERROR;
+    }
+
+    if (msg_dir && archive_path)
+    {
+        print_usage(argv[0]);
+        jobs_free(&jobs);
+        return ERROR;
+    }
+
+    FILE *out = stdout;
+    if (out_path && !(out = fopen(out_path, "w")))
+    {
+        fprintf(stderr, "Error: no se pudo crear %s\n", out_path);
+        jobs_free(&jobs);
+        return ERROR;
+    }
+
+    // Destino de los mensajes: uno por archivo, todos en un archivo con índice o ninguno
+    output_t sink;
+    output_init(&sink);
+    if ((msg_dir && (!check_message_names(&jobs) || !output_open_dir(&sink, msg_dir))) ||
+        (archive_path && !output_open_archive(&sink, archive_path)))
+    {
+        if (out != stdout)
+        {
+            fclose(out);
+        }
+        jobs_free(&jobs);
+        return ERROR;
+    }
+
+    if (n_threads == 0)
+    {
+        n_threads = thread::hardware_concurrency();
+    }
+    if (n_threads == 0)
+    {
+        n_threads = 1;
+    }
+    unsigned int solve_threads = 1;
+    if (n_threads > jobs.count)
+    {
+        solve_threads = n_threads / (unsigned int)jobs.count;
+        n_threads = (unsigned int)jobs.count;
+    }
+
+    trace_reset();
+    if (trace_path && trace_compiled())
+    {
+        trace_events_enable(TRACE_MAX_EVENTS);
+    }
+
+    keycache_t cache;
+    keycache_load(&cache, cache_path);
+
+    // ====== Grupo de hilos: cada uno toma el siguiente par libre ============
+    atomic<size_t> next(0);
+    atomic<size_t> solved(0);
+    atomic<size_t> write_failed(0);
+    mutex out_lock;
+    auto t0 = chrono::steady_clock::now();
+
+    auto worker = [&]()
+    {
+        for (size_t i = next.fetch_add(1); i < jobs.count; i = next.fetch_add(1))
+        {
+            solve_job(&jobs.items[i], &cache, &sink, solve_threads);
+            if (jobs.items[i].found)
+            {
+                solved.fetch_add(1);
+            }
+            if (!jobs.items[i].write_ok)
+            {
+                write_failed.fetch_add(1);
+            }
+
+            // Las líneas se escriben en orden de terminación
+            lock_guard<mutex> guard(out_lock);
+            write_json_line(out, &jobs.items[i]);
+        }
+    };
+
+    thread *pool = new thread[n_threads];
+    for (unsigned int t = 0; t < n_threads; t++)
+    {
+        pool[t] = thread(worker);
+    }
+    for (unsigned int t = 0; t < n_threads; t++)
+    {
+        pool[t].join();
+    }
+    delete[] pool;
+
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    fprintf(stderr, "%zu pares, %zu resueltos, %u hilos, %.3f s (%.1f pares/s)\n",
+            jobs.count, solved.load(), n_threads, secs, secs > 0 ? jobs.count / secs : 0.0);
+
+    if (trace_compiled() || trace_path)
+    {
+        trace_print_summary(stderr);
+    }
+    if (trace_path && trace_compiled())
+    {
+        trace_write_chrome(trace_path);
+    }
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    bool written = output_close(&sink) && write_failed.load() == 0;
+    keycache_free(&cache);
+    jobs_free(&jobs);
+    return written ? OK : ERROR;
+}
@@ -6,10 +6,18 @@
  * ror_8: Rotación de bits a la derecha
  * rol_8: Rotación de bits a la izquierda
  * rle_decompress: Función para la descompresión por medio de RLE
+ * rle_decompress_parallel: Expansión RLE de tamaño exacto repartida entre hilos
  * LZ78_decompress: Función para la descompresión por medio de LZ78
+ * lz78_decompress_parallel: Descompresión LZ78 en dos pasadas repartida entre hilos
+ * rle_stream_* / lz78_stream_*: Decodificadores incrementales que entregan la salida por bloques
+ * rle_compress / lz78_compress: Compresores (generación de corpus de prueba)
+ * classify_stream: Validación estructural de un flujo antes de descomprimirlo
+ * rle_decode / lz78_decode: API por buffers con destino fijo, creciente o por callback
  *
  * Además cuenta con una función auxiliar para la redimensión de un buffer dinamico.
  * grow_and_copy: Función Auxiliar para el redimensionamiento de buffers dinamicos. 
+ * mem_reserve: Reserva espacio al final de un growable_buffer_t.
+ * lz78_decode_syms: Decodificación LZ78 por buffers que conserva o descarta los símbolos NUL.
  * 
  * @authors Julián Sánchez
  *          Jaider Bedoya
@@ -47,6 +55,315 @@ namespace
         return p; // Retorna el nuevo buffer
     }
 
+    /**
+     * @brief   Suma las repeticiones de los triples RLE [first, last).
+     *
+     * @param   in     Datos RLE.
+     * @param   first  Primer triple.
+     * @param   last   Triple siguiente al último.
+     *
+     * @return  Cantidad de bytes que producen esos triples.
+     */
+    size_t rle_count_bytes(const uint8_t *in, size_t first, size_t last)
+    {
+        size_t total = 0;
+        for (size_t t = first; t < last; t++)
+        {
+            total += in[3 * t + 1]; // repeticiones de caracter (el byte 3t es basura)
+        }
+        return total;
+    }
+
+    /**
+     * @brief   Expande los triples RLE [first, last) en @p out con un memset por corrida.
+     *
+     * @param   in     Datos RLE.
+     * @param   first  Primer triple.
+     * @param   last   Triple siguiente al último.
+     * @param   out    Destino con espacio para `rle_count_bytes(in, first, last)` bytes.
+     */
+    void rle_expand(const uint8_t *in, size_t first, size_t last, char *out)
+    {
+        for (size_t t = first; t < last; t++)
+        {
+            uint8_t count = in[3 * t + 1];    // repeticiones de caracter
+            char sym = (char)in[3 * t + 2];   // carácter a repetir
+            memset(out, sym, count);
+            out += count;
+        }
+    }
+
+    /**
+     * @brief   Asegura espacio para @p need bytes más al final de un buffer que crece.
+     *
+     * La capacidad se duplica (desde 512 bytes) para que el costo total sea lineal.
+     */
+    void mem_reserve(growable_buffer_t *g, size_t need)
+    {
+        if (g->len + need <= g->cap)
+        {
+            return;
+        }
+        size_t newcap = g->cap ? g->cap : 512;
+        while (g->len + need > newcap)
+        {
+            newcap *= 2;
+        }
+        g->data = grow_and_copy(g->data, g->len, newcap);
+        g->cap = newcap;
+    }
+
+    /**
+     * @brief   Indica si un símbolo RLE puede pertenecer a un texto.
+     */
+    inline bool is_text_byte(uint8_t c)
+    {
+        return c >= 0x20 || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    // Tabla hash del trie de lz78_compress(): potencia de dos, a lo sumo medio llena
+    const size_t LZ78_HASH_SIZE = 1 << 17;
+
+    /**
+     * @brief   Posición de la clave (padre, símbolo) en la tabla hash del compresor LZ78.
+     *
+     * @param   keys  Claves de la tabla (clave + 1; 0 = libre).
+     * @param   key   Clave buscada: `padre << 8 | símbolo`.
+     *
+     * @return  Posición que contiene la clave o la primera posición libre de su secuencia.
+     */
+    size_t lz78_hash_slot(const uint32_t *keys, uint32_t key)
+    {
+        size_t h = (size_t)((key * 2654435761u) >> 15) & (LZ78_HASH_SIZE - 1);
+        while (keys[h] != 0 && keys[h] != key + 1)
+        {
+            h = (h + 1) & (LZ78_HASH_SIZE - 1);
+        }
+        return h;
+    }
+
+    // Capacidad del bloque LZ78: tras vaciarlo siempre cabe la frase más larga posible
+    const size_t LZ78_CHUNK_CAP = STREAM_CHUNK + LZ78_MAX_INDEX + 1;
+
+    /**
+     * @brief Completa un triple pendiente con bytes de la entrada.
+     *
+     * @param pending    Bytes acumulados del triple.
+     * @param n_pending  Cantidad de bytes acumulados (se actualiza).
+     * @param in         Entrada (avanza lo consumido).
+     * @param len        Longitud restante de la entrada (se actualiza).
+     *
+     * @return `true` si el triple quedó completo.
+     */
+    bool fill_pending(uint8_t *pending, size_t *n_pending, const uint8_t **in, size_t *len)
+    {
+        while (*n_pending < 3 && *len > 0)
+        {
+            pending[(*n_pending)++] = **in;
+            (*in)++;
+            (*len)--;
+        }
+        return *n_pending == 3;
+    }
+
+    /**
+     * @brief Expande un triple RLE en el bloque del decodificador, vaciándolo al sink si se llena.
+     *
+     * @return `false` si el sink pidió detenerse.
+     */
+    bool rle_stream_triple(rle_stream_t *s, const uint8_t *t, chunk_sink_t sink, void *user)
+    {
+        uint8_t count = t[1];   // repeticiones de caracter (t[0] es basura)
+        char sym = (char)t[2];  // carácter a repetir
+
+        while (count > 0)
+        {
+            size_t room = STREAM_CHUNK - s->chunk_len;
+            size_t run = count < room ? count : room;
+
+            memset(s->chunk + s->chunk_len, sym, run);
+            s->chunk_len += run;
+            count = (uint8_t)(count - run);
+
+            if (s->chunk_len == STREAM_CHUNK)
+            {
+                s->out_len += s->chunk_len;
+                s->chunk_len = 0;
+                if (!sink(s->chunk, STREAM_CHUNK, user))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Decodifica un token LZ78 en el bloque del decodificador.
+     *
+     * Con `keep_nul` en false conserva la semántica de `lz78_decompress()`: un símbolo NUL
+     * no se agrega a la frase.
+     *
+     * @return STREAM_MORE, STREAM_STOP si el sink pidió detenerse o STREAM_INVALID.
+     */
+    stream_status_t lz78_stream_token(lz78_stream_t *s, const uint8_t *t, chunk_sink_t sink, void *user)
+    {
+        size_t idx = ((size_t)t[0] << 8) | t[1]; // dos bytes de índice
+        char c = (char)t[2];                     // símbolo
+
+        if (idx > s->dict_count)
+        {
+            return STREAM_INVALID; // índice a una entrada que aún no existe
+        }
+
+        size_t len = (idx ? s->dict[idx].len : 0) + (c != '\0' || s->keep_nul);
+
+        if (s->chunk_len + len > LZ78_CHUNK_CAP)
+        {
+            s->out_len += s->chunk_len;
+            size_t n = s->chunk_len;
+            s->chunk_len = 0;
+            if (!sink(s->chunk, n, user))
+            {
+                return STREAM_STOP;
+            }
+        }
+
+        // Reconstruir la frase de atrás hacia adelante siguiendo la cadena de padres
+        char *pos = s->chunk + s->chunk_len + len;
+        if (c != '\0' || s->keep_nul)
+        {
+            *--pos = c;
+        }
+        for (size_t e = idx; e != 0; e = s->dict[e].parent)
+        {
+            if (s->dict[e].sym != '\0' || s->keep_nul)
+            {
+                *--pos = s->dict[e].sym;
+            }
+        }
+        s->chunk_len += len;
+
+        // Toda entrada nueva ocupa un índice, pero solo las referenciables se guardan
+        s->dict_count++;
+        if (s->dict_count <= LZ78_MAX_INDEX)
+        {
+            lz78_entry_t &ent = s->dict[s->dict_count];
+            ent.len = (uint32_t)len;
+            ent.parent = (uint16_t)idx;
+            ent.sym = c;
+        }
+
+        if (s->chunk_len >= STREAM_CHUNK)
+        {
+            s->out_len += s->chunk_len;
+            size_t n = s->chunk_len;
+            s->chunk_len = 0;
+            if (!sink(s->chunk, n, user))
+            {
+                return STREAM_STOP;
+            }
+        }
+        return STREAM_MORE;
+    }
+
+    /**
+     * @brief Implementación de `lz78_decode()` con la política para los símbolos NUL.
+     *
+     * @param keep_nul true escribe los símbolos NUL como cualquier otro byte (`lz78_decode()`);
+     *                 false los descarta, como espera `lz78_decompress()`.
+     */
+    decode_status_t lz78_decode_syms(byte_span_t in, decode_sink_t *out, size_t *out_len, bool keep_nul)
+    {
+        if (out->kind == SINK_CALLBACK)
+        {
+            lz78_stream_t s;
+            lz78_stream_init(&s);
+            s.keep_nul = keep_nul;
+            stream_status_t st = lz78_stream_feed(&s, in.data, in.len / 3 * 3, out->fn, out->user);
+            if (st != STREAM_STOP)
+            {
+                // También con un índice inválido se entrega lo decodificado antes de él
+                stream_status_t fin = lz78_stream_finish(&s, out->fn, out->user);
+                st = st == STREAM_INVALID ? st : fin;
+            }
+            *out_len = s.out_len;
+            lz78_stream_free(&s);
+            return st == STREAM_MORE ? DECODE_OK : st == STREAM_INVALID ? DECODE_INVALID : DECODE_STOPPED;
+        }
+
+        // Cada entrada del diccionario es una referencia (offset, longitud) a la frase ya
+        // escrita en la salida. Todo token crea una entrada, pero un índice de 16 bits solo
+        // alcanza las primeras LZ78_MAX_INDEX, así que el arena se reserva una sola vez.
+        size_t n_tokens = in.len / 3;
+        size_t dict_cap = n_tokens < LZ78_MAX_INDEX ? n_tokens : LZ78_MAX_INDEX;
+        lz78_ref_t *dict = new lz78_ref_t[dict_cap + 1];
+        dict[0].off = 0; // índice 0: frase vacía
+        dict[0].len = 0;
+        size_t dict_count = 0;
+
+        // Los offsets del diccionario son relativos al inicio de esta salida
+        growable_buffer_t *g = out->kind == SINK_GROWABLE ? out->grow : nullptr;
+        size_t base = g ? g->len : 0;
+        char *dst = g ? g->data + base : out->buf;
+        size_t cap = g ? g->cap - base : out->cap;
+        size_t pos = 0;
+        decode_status_t status = DECODE_OK;
+
+        for (size_t t = 0; t < n_tokens; t++)
+        {
+            const uint8_t *tk = in.data + 3 * t;
+            size_t idx = ((size_t)tk[0] << 8) | tk[1]; // dos bytes de índice
+            char c = (char)tk[2];                      // símbolo
+
+            if (idx > dict_count)
+            {
+                status = DECODE_INVALID; // índice a una entrada que aún no existe
+                break;
+            }
+
+            // La frase es la del padre más el símbolo; sin keep_nul un símbolo NUL no se agrega
+            lz78_ref_t pref = dict[idx];
+            size_t slen = pref.len + (c != '\0' || keep_nul);
+
+            if (pos + slen > cap)
+            {
+                if (!g)
+                {
+                    status = DECODE_NO_SPACE;
+                    break;
+                }
+                g->len = base + pos;
+                mem_reserve(g, slen);
+                dst = g->data + base;
+                cap = g->cap - base;
+            }
+
+            // Una sola copia acotada desde la posición donde ya se escribió el padre
+            memcpy(dst + pos, dst + pref.off, pref.len);
+            if (c != '\0' || keep_nul)
+            {
+                dst[pos + pref.len] = c;
+            }
+
+            if (dict_count < dict_cap)
+            {
+                dict[dict_count + 1].off = pos;
+                dict[dict_count + 1].len = slen;
+            }
+            dict_count++;
+            pos += slen;
+        }
+
+        delete[] dict;
+        if (g)
+        {
+            g->len = base + pos;
+        }
+        *out_len = pos;
+        return status;
+    }
+
 }
 
 uint8_t ror_8(uint8_t v, unsigned int n)
@@ -61,96 +378,611 @@ uint8_t rol_8(uint8_t v, unsigned int n)
 
 char *rle_decompress(const uint8_t* in, size_t len)
 {
-    size_t cap = 256;
-    char *out = new char[cap];
+    // Primera pasada: el tamaño exacto de la salida es la suma de las repeticiones
+    size_t out_len = rle_count_bytes(in, 0, len / 3);
+    char *out = new char[out_len + 1];
+
+    // Segunda pasada: cada corrida se escribe de una sola vez
+    rle_expand(in, 0, len / 3, out);
+
+    out[out_len] = '\0';
+    return out;
+}
+
+char *rle_decompress_parallel(const uint8_t *in, size_t len, unsigned int n_threads)
+{
+    size_t n_triples = len / 3;
+
+    if (n_threads == 0)
+    {
+        n_threads = thread::hardware_concurrency();
+    }
+    if (n_threads <= 1 || n_triples < RLE_PARALLEL_MIN)
+    {
+        return rle_decompress(in, len);
+    }
+
+    size_t *block_start = new size_t[n_threads + 1];
+    size_t *block_off = new size_t[n_threads + 1];
+    for (unsigned int b = 0; b <= n_threads; b++)
+    {
+        block_start[b] = n_triples * b / n_threads;
+    }
+
+    thread *pool = new thread[n_threads];
+
+    // Pasada 1: bytes de salida de cada bloque de triples
+    for (unsigned int b = 0; b < n_threads; b++)
+    {
+        pool[b] = thread([=]()
+        {
+            block_off[b + 1] = rle_count_bytes(in, block_start[b], block_start[b + 1]);
+        });
+    }
+    for (unsigned int b = 0; b < n_threads; b++)
+    {
+        pool[b].join();
+    }
+
+    // Suma prefija: posición de salida de cada bloque
+    block_off[0] = 0;
+    for (unsigned int b = 0; b < n_threads; b++)
+    {
+        block_off[b + 1] += block_off[b];
+    }
+
+    size_t out_len = block_off[n_threads];
+    char *out = new char[out_len + 1];
+
+    // Pasada 2: cada hilo expande sus corridas en su propia región
+    for (unsigned int b = 0; b < n_threads; b++)
+    {
+        pool[b] = thread([=]()
+        {
+            rle_expand(in, block_start[b], block_start[b + 1], out + block_off[b]);
+        });
+    }
+    for (unsigned int b = 0; b < n_threads; b++)
+    {
+        pool[b].join();
+    }
+
+    out[out_len] = '\0';
+
+    delete[] pool;
+    delete[] block_off;
+    delete[] block_start;
+    return out;
+}
+
+
+char *lz78_decompress(const uint8_t *in, size_t len)
+{
+    growable_buffer_t buf;
+    decode_sink_t sink = sink_growable(&buf);
     size_t out_len = 0;
 
-    for (size_t i = 0; i + 2 < len; i += 3)
+    byte_span_t span = {in, len};
+    if (lz78_decode_syms(span, &sink, &out_len, false) != DECODE_OK) // NUL descartado
+    {
+        return nullptr; // error: índice inválido
+    }
+
+    // Terminador para los llamadores que usan el mensaje como C-string
+    mem_reserve(&buf, 1);
+    buf.data[out_len] = '\0';
+    return buf.release();
+}
+
+char *lz78_decompress_parallel(const uint8_t *in, size_t len, unsigned int n_threads)
+{
+    size_t n_tokens = len / 3;
+
+    if (n_threads == 0)
+    {
+        n_threads = thread::hardware_concurrency();
+    }
+    if (n_threads <= 1 || n_tokens <= LZ78_MAX_INDEX)
+    {
+        return lz78_decompress(in, len);
+    }
+
+    // ====== Prefijo: los únicos tokens que pueden ser padres ============
+    // Un índice de 16 bits solo referencia las entradas 1..LZ78_MAX_INDEX, creadas por los
+    // primeros LZ78_MAX_INDEX tokens. Aquí se validan y se calcula la longitud de sus frases.
+    lz78_ref_t *dict = new lz78_ref_t[LZ78_MAX_INDEX + 1];
+    dict[0].off = 0;
+    dict[0].len = 0;
+
+    size_t prefix_len = 0;
+    for (size_t t = 0; t < LZ78_MAX_INDEX; t++)
+    {
+        const uint8_t *tk = in + 3 * t;
+        size_t idx = ((size_t)tk[0] << 8) | tk[1];
+        if (idx > t)
+        {
+            delete[] dict;
+            return nullptr; // índice inválido
+        }
+        size_t slen = dict[idx].len + (tk[2] != '\0');
+        dict[t + 1].off = prefix_len;
+        dict[t + 1].len = slen;
+        prefix_len += slen;
+    }
+
+    // Del token LZ78_MAX_INDEX en adelante todo índice es válido (dict_count >= 65535)
+    // y la longitud de cada frase depende solo del padre, ya conocido.
+    size_t rest = n_tokens - LZ78_MAX_INDEX;
+    if (n_threads > rest)
+    {
+        n_threads = (unsigned int)rest;
+    }
+
+    size_t *block_start = new size_t[n_threads + 1];
+    size_t *block_bytes = new size_t[n_threads];
+    for (unsigned int b = 0; b <= n_threads; b++)
+    {
+        block_start[b] = LZ78_MAX_INDEX + rest * b / n_threads;
+    }
+
+    thread *pool = new thread[n_threads];
+
+    // ====== Pasada 1: bytes de salida de cada bloque de tokens ============
+    for (unsigned int b = 0; b < n_threads; b++)
+    {
+        pool[b] = thread([=]()
+        {
+            size_t sum = 0;
+            for (size_t t = block_start[b]; t < block_start[b + 1]; t++)
+            {
+                const uint8_t *tk = in + 3 * t;
+                size_t idx = ((size_t)tk[0] << 8) | tk[1];
+                sum += dict[idx].len + (tk[2] != '\0');
+            }
+            block_bytes[b] = sum;
+        });
+    }
+    for (unsigned int b = 0; b < n_threads; b++)
+    {
+        pool[b].join();
+    }
+
+    // Suma prefija: posición de salida de cada bloque y tamaño exacto del mensaje
+    size_t *block_off = new size_t[n_threads];
+    size_t out_len = prefix_len;
+    for (unsigned int b = 0; b < n_threads; b++)
     {
-        // Este bloque existe solo para honrar la brillante ocurrencia de empaquetar basura 
-        uint8_t basura = in[i];   // primer byte completamente inútil
-        (void)basura;             // para silenciar warnings
-        
-        uint8_t count = in[i + 1];         // repeticiones de caracter
-        char sym = (char)in[i + 2];        // carácter a repetir
+        block_off[b] = out_len;
+        out_len += block_bytes[b];
+    }
+
+    char *out = new char[out_len + 1];
 
-        // crecer si hace falta
-        if (out_len + count + 1 > cap) {
-            size_t newcap = cap;
-            while (out_len + count + 1 > newcap)
-                newcap *= 2;
-            out = grow_and_copy(out, cap, newcap);
-            cap = newcap;
+    // El prefijo se escribe en serie: sus frases dependen unas de otras
+    for (size_t t = 0; t < LZ78_MAX_INDEX; t++)
+    {
+        const uint8_t *tk = in + 3 * t;
+        size_t idx = ((size_t)tk[0] << 8) | tk[1];
+        lz78_ref_t pref = dict[idx];
+        memcpy(out + dict[t + 1].off, out + pref.off, pref.len);
+        if (tk[2] != '\0')
+        {
+            out[dict[t + 1].off + pref.len] = (char)tk[2];
         }
+    }
 
-        for (uint8_t k = 0; k < count; ++k)
-            out[out_len++] = sym;
+    // ====== Pasada 2: cada frase se copia desde la posición del padre en el prefijo ============
+    for (unsigned int b = 0; b < n_threads; b++)
+    {
+        pool[b] = thread([=]()
+        {
+            size_t pos = block_off[b];
+            for (size_t t = block_start[b]; t < block_start[b + 1]; t++)
+            {
+                const uint8_t *tk = in + 3 * t;
+                size_t idx = ((size_t)tk[0] << 8) | tk[1];
+                lz78_ref_t pref = dict[idx];
+                memcpy(out + pos, out + pref.off, pref.len);
+                pos += pref.len;
+                if (tk[2] != '\0')
+                {
+                    out[pos++] = (char)tk[2];
+                }
+            }
+        });
+    }
+    for (unsigned int b = 0; b < n_threads; b++)
+    {
+        pool[b].join();
     }
 
     out[out_len] = '\0';
+
+    delete[] pool;
+    delete[] block_off;
+    delete[] block_bytes;
+    delete[] block_start;
+    delete[] dict;
     return out;
 }
 
+void rle_stream_init(rle_stream_t *s)
+{
+    s->n_pending = 0;
+    s->out_len = 0;
+    s->chunk_len = 0;
+}
 
-char *lz78_decompress(const uint8_t *in, size_t len)
+stream_status_t rle_stream_feed(rle_stream_t *s, const uint8_t *in, size_t len, chunk_sink_t sink, void *user)
 {
-    size_t dict_cap = 1024;
-    char **dict = new char *[dict_cap];
-    size_t dict_count = 0;
+    // Terminar el triple que quedó partido en la llamada anterior
+    if (s->n_pending > 0)
+    {
+        if (!fill_pending(s->pending, &s->n_pending, &in, &len))
+        {
+            return STREAM_MORE;
+        }
+        s->n_pending = 0;
+        if (!rle_stream_triple(s, s->pending, sink, user))
+        {
+            return STREAM_STOP;
+        }
+    }
 
-    size_t out_cap = 512;
-    char *out = new char[out_cap];
-    size_t out_len = 0;
+    size_t i = 0;
+    for (; i + 2 < len; i += 3)
+    {
+        if (!rle_stream_triple(s, in + i, sink, user))
+        {
+            return STREAM_STOP;
+        }
+    }
+
+    // Guardar el resto para la próxima llamada
+    for (; i < len; i++)
+    {
+        s->pending[s->n_pending++] = in[i];
+    }
+    return STREAM_MORE;
+}
+
+stream_status_t rle_stream_finish(rle_stream_t *s, chunk_sink_t sink, void *user)
+{
+    if (s->chunk_len == 0)
+    {
+        return STREAM_MORE;
+    }
+
+    size_t n = s->chunk_len;
+    s->out_len += n;
+    s->chunk_len = 0;
+    return sink(s->chunk, n, user) ? STREAM_MORE : STREAM_STOP;
+}
+
+
+void lz78_stream_init(lz78_stream_t *s)
+{
+    s->dict = new lz78_entry_t[LZ78_MAX_INDEX + 1];
+    s->dict[0].len = 0;
+    s->dict[0].parent = 0;
+    s->dict[0].sym = '\0';
+    s->keep_nul = false;
+    s->chunk = new char[LZ78_CHUNK_CAP];
+    lz78_stream_reset(s);
+}
+
+void lz78_stream_reset(lz78_stream_t *s)
+{
+    // Las entradas viejas del diccionario se sobrescriben antes de volver a ser referenciables
+    s->dict_count = 0;
+    s->n_pending = 0;
+    s->out_len = 0;
+    s->chunk_len = 0;
+}
+
+void lz78_stream_free(lz78_stream_t *s)
+{
+    delete[] s->dict;
+    delete[] s->chunk;
+    s->dict = nullptr;
+    s->chunk = nullptr;
+}
+
+stream_status_t lz78_stream_feed(lz78_stream_t *s, const uint8_t *in, size_t len, chunk_sink_t sink, void *user)
+{
+    // Terminar el triple que quedó partido en la llamada anterior
+    if (s->n_pending > 0)
+    {
+        if (!fill_pending(s->pending, &s->n_pending, &in, &len))
+        {
+            return STREAM_MORE;
+        }
+        s->n_pending = 0;
+        stream_status_t st = lz78_stream_token(s, s->pending, sink, user);
+        if (st != STREAM_MORE)
+        {
+            return st;
+        }
+    }
+
+    size_t i = 0;
+    for (; i + 2 < len; i += 3)
+    {
+        stream_status_t st = lz78_stream_token(s, in + i, sink, user);
+        if (st != STREAM_MORE)
+        {
+            return st;
+        }
+    }
+
+    // Guardar el resto para la próxima llamada
+    for (; i < len; i++)
+    {
+        s->pending[s->n_pending++] = in[i];
+    }
+    return STREAM_MORE;
+}
 
-    for (size_t i = 0; i + 2 < len; i += 3)
-    {
-        uint16_t idx = ((uint16_t)in[i] << 8) | in[i + 1]; // dos bytes de índice
-        char c = (char)in[i + 2];                          // símbolo
-
-        char *s = nullptr;
-        if (idx == 0) {
-            s = new char[2]{c, '\0'};
-        } else {
-            if (idx > dict_count) {
-                // error: índice inválido
-                for (size_t j = 0; j < dict_count; ++j) delete[] dict[j];
-                delete[] dict;
-                delete[] out;
-                return nullptr;
+stream_status_t lz78_stream_finish(lz78_stream_t *s, chunk_sink_t sink, void *user)
+{
+    if (s->chunk_len == 0)
+    {
+        return STREAM_MORE;
+    }
+
+    size_t n = s->chunk_len;
+    s->out_len += n;
+    s->chunk_len = 0;
+    return sink(s->chunk, n, user) ? STREAM_MORE : STREAM_STOP;
+}
+
+
+decode_sink_t sink_fixed(char *buf, size_t cap)
+{
+    decode_sink_t s = {SINK_FIXED, buf, cap, nullptr, nullptr, nullptr};
+    return s;
+}
+
+decode_sink_t sink_growable(growable_buffer_t *buf)
+{
+    decode_sink_t s = {SINK_GROWABLE, nullptr, 0, buf, nullptr, nullptr};
+    return s;
+}
+
+decode_sink_t sink_callback(chunk_sink_t fn, void *user)
+{
+    decode_sink_t s = {SINK_CALLBACK, nullptr, 0, nullptr, fn, user};
+    return s;
+}
+
+size_t rle_decoded_size(byte_span_t in)
+{
+    return rle_count_bytes(in.data, 0, in.len / 3);
+}
+
+decode_status_t rle_decode(byte_span_t in, decode_sink_t *out, size_t *out_len)
+{
+    size_t n_triples = in.len / 3;
+
+    if (out->kind == SINK_CALLBACK)
+    {
+        rle_stream_t s;
+        rle_stream_init(&s);
+        stream_status_t st = rle_stream_feed(&s, in.data, 3 * n_triples, out->fn, out->user);
+        if (st == STREAM_MORE)
+        {
+            st = rle_stream_finish(&s, out->fn, out->user);
+        }
+        *out_len = s.out_len;
+        return st == STREAM_MORE ? DECODE_OK : DECODE_STOPPED;
+    }
+
+    size_t need = rle_count_bytes(in.data, 0, n_triples);
+
+    if (out->kind == SINK_GROWABLE)
+    {
+        growable_buffer_t *g = out->grow;
+        mem_reserve(g, need);
+        rle_expand(in.data, 0, n_triples, g->data + g->len);
+        g->len += need;
+        *out_len = need;
+        return DECODE_OK;
+    }
+
+    if (need <= out->cap)
+    {
+        rle_expand(in.data, 0, n_triples, out->buf);
+        *out_len = need;
+        return DECODE_OK;
+    }
+
+    // Buffer fijo insuficiente: se escribe el prefijo que cabe
+    size_t pos = 0;
+    for (size_t t = 0; t < n_triples && pos < out->cap; t++)
+    {
+        size_t count = in.data[3 * t + 1];
+        size_t room = out->cap - pos;
+        count = count < room ? count : room;
+        memset(out->buf + pos, (char)in.data[3 * t + 2], count);
+        pos += count;
+    }
+    *out_len = pos;
+    return DECODE_NO_SPACE;
+}
+
+decode_status_t lz78_decode(byte_span_t in, decode_sink_t *out, size_t *out_len)
+{
+    return lz78_decode_syms(in, out, out_len, true);
+}
+
+
+void classifier_init(codec_classifier_t *c)
+{
+    c->tokens = 0;
+    c->rle_ok = true;
+    c->rle_done = false;
+    c->lz_ok = true;
+}
+
+bool classifier_feed(codec_classifier_t *c, const uint8_t *dec, size_t len)
+{
+    size_t n_triples = len / 3;
+    bool rle_ok = c->rle_ok;
+    bool rle_done = c->rle_done;
+    bool lz_ok = c->lz_ok;
+    size_t t = 0;
+
+    for (; t < n_triples && ((rle_ok && !rle_done) || lz_ok); t++)
+    {
+        const uint8_t *p = dec + 3 * t;
+
+        if (rle_ok && !rle_done)
+        {
+            if (p[1] == 0)
+            {
+                rle_ok = false;     // corrida vacía
+            }
+            else if (p[2] == 0)
+            {
+                rle_done = true;    // el resto no llega al texto
             }
-            char *pref = dict[idx - 1];
-            size_t plen = strlen(pref);
-            s = new char[plen + 2];
-            memcpy(s, pref, plen);
-            s[plen] = c;
-            s[plen + 1] = '\0';
-        }
-
-        size_t slen = strlen(s);
-        if (out_len + slen + 1 > out_cap) {
-            size_t newcap = out_cap;
-            while (out_len + slen + 1 > newcap)
-                newcap *= 2;
-            out = grow_and_copy(out, out_cap, newcap);
+            else if (!is_text_byte(p[2]))
+            {
+                rle_ok = false;
+            }
+        }
+
+        // El token puede referirse a la frase vacía o a cualquiera de los anteriores
+        if (lz_ok && ((((size_t)p[0] << 8) | p[1]) > c->tokens + t))
+        {
+            lz_ok = false;
+        }
+    }
+
+    // Si se cortó antes, los triples restantes ya no cambian el resultado
+    c->tokens += n_triples;
+    c->rle_ok = rle_ok;
+    c->rle_done = rle_done;
+    c->lz_ok = lz_ok;
+    return rle_ok || lz_ok;
+}
+
+codec_class_t classifier_result(const codec_classifier_t *c)
+{
+    return (codec_class_t)((c->rle_ok ? CODEC_RLE : 0) | (c->lz_ok ? CODEC_LZ78 : 0));
+}
+
+codec_class_t classify_stream(const uint8_t *dec, size_t len)
+{
+    codec_classifier_t c;
+    classifier_init(&c);
+    classifier_feed(&c, dec, len);
+    return classifier_result(&c);
+}
+
+
+uint8_t *rle_compress(const char *in, size_t len, size_t *out_len)
+{
+    // Primera pasada: cantidad exacta de triples
+    size_t n_triples = 0;
+    for (size_t i = 0; i < len;)
+    {
+        size_t j = i + 1;
+        while (j < len && in[j] == in[i] && j - i < 255)
+            j++;
+        n_triples++;
+        i = j;
+    }
+
+    uint8_t *out = new uint8_t[3 * n_triples];
+    uint8_t *w = out;
+
+    // Segunda pasada: (basura = 0, repeticiones, símbolo)
+    for (size_t i = 0; i < len;)
+    {
+        size_t j = i + 1;
+        while (j < len && in[j] == in[i] && j - i < 255)
+            j++;
+        w[0] = 0;
+        w[1] = (uint8_t)(j - i);
+        w[2] = (uint8_t)in[i];
+        w += 3;
+        i = j;
+    }
+
+    *out_len = 3 * n_triples;
+    return out;
+}
+
+
+uint8_t *lz78_compress(const char *in, size_t len, size_t *out_len)
+{
+    // Trie: hijos en una tabla hash (padre, símbolo) -> nodo; nodo = índice de la frase
+    uint32_t *keys = new uint32_t[LZ78_HASH_SIZE]();
+    uint16_t *child = new uint16_t[LZ78_HASH_SIZE];
+    uint16_t *node_parent = new uint16_t[LZ78_MAX_INDEX + 1];
+    char *node_sym = new char[LZ78_MAX_INDEX + 1];
+
+    size_t out_cap = 3 * 1024;
+    uint8_t *out = new uint8_t[out_cap];
+    size_t n_out = 0;
+    size_t n_tokens = 0;
+
+    auto emit = [&](size_t idx, char c)
+    {
+        if (n_out + 3 > out_cap)
+        {
+            size_t newcap = out_cap * 2;
+            uint8_t *bigger = new uint8_t[newcap];
+            memcpy(bigger, out, n_out);
+            delete[] out;
+            out = bigger;
             out_cap = newcap;
         }
+        out[n_out++] = (uint8_t)(idx >> 8);
+        out[n_out++] = (uint8_t)(idx & 0xFF);
+        out[n_out++] = (uint8_t)c;
 
-        memcpy(out + out_len, s, slen);
-        out_len += slen;
-        out[out_len] = '\0';
+        // Toda emisión crea una entrada en el decodificador; solo las referenciables se guardan
+        n_tokens++;
+        return n_tokens;
+    };
 
-        if (dict_count + 1 > dict_cap) {
-            size_t newcap = dict_cap * 2;
-            char **nd = new char *[newcap];
-            for (size_t j = 0; j < dict_count; ++j) nd[j] = dict[j];
-            delete[] dict;
-            dict = nd;
-            dict_cap = newcap;
+    size_t node = 0; // frase actual (0 = vacía)
+    for (size_t i = 0; i < len; i++)
+    {
+        char c = in[i];
+        uint32_t key = ((uint32_t)node << 8) | (uint8_t)c;
+        size_t h = lz78_hash_slot(keys, key);
+
+        if (keys[h] != 0)
+        {
+            node = child[h]; // la frase sigue en el diccionario
+            continue;
+        }
+
+        size_t id = emit(node, c);
+        if (id <= LZ78_MAX_INDEX)
+        {
+            keys[h] = key + 1;
+            child[h] = (uint16_t)id;
+            node_parent[id] = (uint16_t)node;
+            node_sym[id] = c;
         }
-        dict[dict_count++] = s;
+        node = 0;
     }
 
-    for (size_t j = 0; j < dict_count; ++j) delete[] dict[j];
-    delete[] dict;
+    // Si el texto termina a mitad de una frase conocida: (padre, último símbolo)
+    if (node != 0)
+    {
+        emit(node_parent[node], node_sym[node]);
+    }
+
+    delete[] keys;
+    delete[] child;
+    delete[] node_parent;
+    delete[] node_sym;
+
+    *out_len = n_out;
     return out;
 }
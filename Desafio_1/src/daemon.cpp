@@ -0,0 +1,762 @@
+/**
+ * @file daemon.cpp
+ * @brief Implementación del modo demonio (servidor por socket Unix)
+ *
+ * Este modulo contiene:
+ *      - daemon_main: Socket, grupo de hilos permanente y ciclo de aceptación
+ * Ademas cuenta con funciones auxiliares:
+ *      - conn_acquire / conn_release: Conexión compartida entre su lector y los trabajadores
+ *      - queue_push / queue_pop: Cola acotada de trabajos
+ *      - reader_loop: Lee los pedidos de una conexión y los encola
+ *      - solve_request: Resuelve un pedido y envía el resultado
+ *
+ * Los trabajadores llaman a `finder_cached()` con un solo hilo, igual que el modo por lotes;
+ * como son siempre los mismos hilos, la memoria de trabajo del solver (ver `scratch_t` en
+ * solver.cpp) queda reservada entre un pedido y el siguiente.
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <daemon.hpp>
+#include <output.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <mutex>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    // Cabecera de un pedido: "DATA <id> <largo> <largo>\n"
+    const size_t HEADER_MAX = 160;
+
+    // Buffer de lectura por conexión
+    const size_t READ_BUF = 64 * 1024;
+
+    // Cada cuánto el ciclo de aceptación revisa si llegó una señal
+    const int ACCEPT_POLL_MS = 200;
+
+    volatile sig_atomic_t stop_requested = 0;
+
+    void on_signal(int)
+    {
+        stop_requested = 1;
+    }
+
+    /**
+     * @struct conn_t
+     * @brief Una conexión de cliente.
+     *
+     * La comparten su hilo lector y los trabajos en curso; el descriptor se cierra cuando
+     * el último de ellos la suelta, así que un resultado nunca se escribe en un descriptor
+     * ya reutilizado.
+     */
+    typedef struct conn_t {
+        int fd;                     /**< Socket del cliente. */
+        atomic<int> refs;           /**< Lector + trabajos pendientes. */
+        mutex write_lock;           /**< Una respuesta (línea + mensaje) a la vez. */
+        bool broken;                /**< Falló una escritura: se descartan las siguientes. */
+        struct conn_t *prev;        /**< Lista de conexiones activas. */
+        struct conn_t *next;
+    } conn_t;
+
+    /**
+     * @struct request_t
+     * @brief Un pedido leído del socket.
+     */
+    typedef struct {
+        conn_t *conn;               /**< Conexión a la que se responde. */
+        char id[DAEMON_ID_MAX + 1]; /**< Identificador del cliente. */
+        char *path;                 /**< Ruta del encriptado (PATH) o nullptr. */
+        uint8_t *data;              /**< Texto cifrado (DATA) o nullptr. */
+        size_t data_len;            /**< Longitud de @p data. */
+        char *hint;                 /**< Pista terminada en NUL. */
+    } request_t;
+
+    /**
+     * @struct request_queue_t
+     * @brief Cola circular acotada: si se llena, los lectores esperan.
+     */
+    typedef struct {
+        request_t **items;
+        size_t cap;
+        size_t head;
+        size_t count;
+        bool closed;                /**< No entran más pedidos; los trabajadores vacían y salen. */
+        mutex lock;
+        condition_variable not_empty;
+        condition_variable not_full;
+    } request_queue_t;
+
+    /**
+     * @struct server_t
+     * @brief Estado compartido del servidor.
+     */
+    typedef struct {
+        keycache_t *cache;          /**< Caché de claves compartida. */
+        request_queue_t queue;      /**< Pedidos pendientes. */
+        mutex conns_lock;           /**< Protege la lista de conexiones y el contador de lectores. */
+        condition_variable readers_done;
+        conn_t *conns;              /**< Conexiones con lector activo. */
+        size_t readers;             /**< Lectores vivos. */
+        atomic<size_t> n_conns;     /**< Conexiones aceptadas. */
+        atomic<size_t> n_jobs;      /**< Pedidos resueltos. */
+        atomic<size_t> n_found;     /**< Pedidos con clave encontrada. */
+    } server_t;
+
+    void conn_acquire(conn_t *c)
+    {
+        c->refs.fetch_add(1);
+    }
+
+    void conn_release(conn_t *c)
+    {
+        if (c->refs.fetch_sub(1) == 1)
+        {
+            close(c->fd);
+            delete c;
+        }
+    }
+
+    void request_free(request_t *r)
+    {
+        delete[] r->path;
+        delete[] r->data;
+        delete[] r->hint;
+        delete r;
+    }
+
+    /**
+     * @brief Encola un pedido; espera si la cola está llena.
+     *
+     * @return `false` si la cola ya se cerró (el pedido no se encoló).
+     */
+    bool queue_push(request_queue_t *q, request_t *r)
+    {
+        unique_lock<mutex> guard(q->lock);
+        q->not_full.wait(guard, [q]() { return q->count < q->cap || q->closed; });
+        if (q->closed)
+        {
+            return false;
+        }
+        q->items[(q->head + q->count) % q->cap] = r;
+        q->count++;
+        q->not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Saca el siguiente pedido; espera si la cola está vacía.
+     *
+     * @return nullptr cuando la cola está cerrada y vacía.
+     */
+    request_t *queue_pop(request_queue_t *q)
+    {
+        unique_lock<mutex> guard(q->lock);
+        q->not_empty.wait(guard, [q]() { return q->count > 0 || q->closed; });
+        if (q->count == 0)
+        {
+            return nullptr;
+        }
+        request_t *r = q->items[q->head];
+        q->head = (q->head + 1) % q->cap;
+        q->count--;
+        q->not_full.notify_one();
+        return r;
+    }
+
+    void queue_close(request_queue_t *q)
+    {
+        lock_guard<mutex> guard(q->lock);
+        q->closed = true;
+        q->not_empty.notify_all();
+        q->not_full.notify_all();
+    }
+
+    /**
+     * @brief Envía una línea JSON y, si hay, el mensaje, sin mezclarse con otras respuestas.
+     */
+    void conn_send(conn_t *c, const char *line, size_t line_len, const char *msg, size_t msg_len)
+    {
+        struct iovec iov[2];
+        iov[0].iov_base = (void *)line;
+        iov[0].iov_len = line_len;
+        iov[1].iov_base = (void *)msg;
+        iov[1].iov_len = msg_len;
+
+        lock_guard<mutex> guard(c->write_lock);
+        if (!c->broken && !output_writev(c->fd, iov, msg_len > 0 ? 2 : 1))
+        {
+            c->broken = true; // el cliente se fue: los demás resultados se descartan
+        }
+    }
+
+    /**
+     * @brief Resuelve un pedido y envía el resultado por su conexión.
+     */
+    void solve_request(server_t *srv, request_t *r)
+    {
+        auto t0 = chrono::steady_clock::now();
+
+        input_view_t enc_view;
+        const uint8_t *enc = r->data;
+        size_t enc_len = r->data_len;
+        bool read_ok = true;
+        if (r->path)
+        {
+            read_ok = input_open(r->path, &enc_view);
+            enc = enc_view.data;
+            enc_len = enc_view.len;
+        }
+
+        bool found = false;
+        char *out_msg = nullptr;
+        char *out_method = nullptr;
+        uint8_t n = 0, k = 0;
+        uint8_t key[KEY_LEN_MAX];
+        size_t key_len = 1;
+
+        // Un cifrado vacío no tiene clave; el solucionador lo reportaría por stdout
+        if (read_ok && enc_len > 0)
+        {
+            found = finder_cached(srv->cache, enc, enc_len, r->hint, &out_msg, &out_method, &n, &k, 1);
+            if (!found)
+            {
+                found = finder_multikey(enc, enc_len, r->hint, &out_msg, &out_method, &n, key, &key_len);
+            }
+        }
+        if (read_ok && r->path)
+        {
+            input_close(&enc_view);
+        }
+
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+        char line[HEADER_MAX + 2 * KEY_LEN_MAX + DAEMON_ID_MAX];
+        int line_len;
+        size_t msg_len = 0;
+        if (!read_ok)
+        {
+            line_len = snprintf(line, sizeof(line), "{\"id\":\"%s\",\"found\":false,\"error\":\"no se pudo leer\",\"ms\":%.3f}\n",
+                                r->id, ms);
+        }
+        else if (!found)
+        {
+            line_len = snprintf(line, sizeof(line), "{\"id\":\"%s\",\"found\":false,\"ms\":%.3f}\n", r->id, ms);
+        }
+        else
+        {
+            msg_len = strlen(out_msg);
+            const char *method = strcmp(out_method, "RLE") == 0 ? "RLE" : "LZ78";
+            if (key_len > 1)
+            {
+                char hex[2 * KEY_LEN_MAX + 1];
+                for (size_t i = 0; i < key_len; i++)
+                {
+                    snprintf(hex + 2 * i, 3, "%02x", key[i]);
+                }
+                line_len = snprintf(line, sizeof(line),
+                                    "{\"id\":\"%s\",\"found\":true,\"n\":%u,\"key\":\"%s\",\"method\":\"%s\",\"len\":%zu,\"ms\":%.3f}\n",
+                                    r->id, (unsigned)n, hex, method, msg_len, ms);
+            }
+            else
+            {
+                line_len = snprintf(line, sizeof(line),
+                                    "{\"id\":\"%s\",\"found\":true,\"n\":%u,\"k\":%u,\"method\":\"%s\",\"len\":%zu,\"ms\":%.3f}\n",
+                                    r->id, (unsigned)n, (unsigned)k, method, msg_len, ms);
+            }
+        }
+
+        conn_send(r->conn, line, (size_t)line_len, out_msg, msg_len);
+
+        srv->n_jobs.fetch_add(1);
+        if (found)
+        {
+            srv->n_found.fetch_add(1);
+            delete[] out_msg;
+            delete[] out_method;
+        }
+    }
+
+    void worker_loop(server_t *srv)
+    {
+        for (request_t *r = queue_pop(&srv->queue); r; r = queue_pop(&srv->queue))
+        {
+            solve_request(srv, r);
+            conn_release(r->conn);
+            request_free(r);
+        }
+    }
+
+    /**
+     * @struct reader_t
+     * @brief Lectura con buffer de una conexión.
+     */
+    typedef struct {
+        int fd;
+        char *buf;
+        size_t pos;
+        size_t end;
+    } reader_t;
+
+    /**
+     * @brief Rellena el buffer.
+     *
+     * @return `false` en fin de archivo o error.
+     */
+    bool reader_fill(reader_t *rd)
+    {
+        for (;;)
+        {
+            ssize_t r = read(rd->fd, rd->buf, READ_BUF);
+            if (r < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (r <= 0)
+            {
+                return false;
+            }
+            rd->pos = 0;
+            rd->end = (size_t)r;
+            return true;
+        }
+    }
+
+    /**
+     * @brief Lee una línea de cabecera (sin el '\\n').
+     *
+     * @return 1 si hay línea, 0 si la conexión terminó limpia, -1 si la línea es demasiado larga
+     *         o la conexión se cortó a mitad.
+     */
+    int reader_line(reader_t *rd, char *line, size_t cap)
+    {
+        size_t len = 0;
+        for (;;)
+        {
+            if (rd->pos == rd->end && !reader_fill(rd))
+            {
+                return len == 0 ? 0 : -1;
+            }
+            char c = rd->buf[rd->pos++];
+            if (c == '\n')
+            {
+                line[len] = '\0';
+                return 1;
+            }
+            if (len + 1 == cap)
+            {
+                return -1;
+            }
+            line[len++] = c;
+        }
+    }
+
+    /**
+     * @brief Lee exactamente @p len bytes; lo que no está en el buffer se lee directo al destino.
+     */
+    bool reader_exact(reader_t *rd, uint8_t *dst, size_t len)
+    {
+        size_t have = rd->end - rd->pos;
+        size_t take = have < len ? have : len;
+        memcpy(dst, rd->buf + rd->pos, take);
+        rd->pos += take;
+        dst += take;
+        len -= take;
+
+        while (len > 0)
+        {
+            ssize_t r = read(rd->fd, dst, len);
+            if (r < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (r <= 0)
+            {
+                return false;
+            }
+            dst += r;
+            len -= (size_t)r;
+        }
+        return true;
+    }
+
+    bool valid_id(const char *id)
+    {
+        if (*id == '\0')
+        {
+            return false;
+        }
+        for (; *id; id++)
+        {
+            char c = *id;
+            bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                      c == '_' || c == '-' || c == '.' || c == ':';
+            if (!ok)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Responde un error de protocolo (la conexión se cierra después).
+     */
+    void send_error(conn_t *c, const char *what)
+    {
+        char line[HEADER_MAX];
+        int len = snprintf(line, sizeof(line), "{\"id\":\"\",\"error\":\"%s\"}\n", what);
+        conn_send(c, line, (size_t)len, nullptr, 0);
+    }
+
+    /**
+     * @brief Lee los pedidos de una conexión hasta que se cierre y los pasa a la cola.
+     */
+    void reader_loop(server_t *srv, conn_t *c)
+    {
+        reader_t rd = {c->fd, new char[READ_BUF], 0, 0};
+        char header[HEADER_MAX];
+
+        for (;;)
+        {
+            int got = reader_line(&rd, header, sizeof(header));
+            if (got == 0)
+            {
+                break;
+            }
+            if (got < 0)
+            {
+                send_error(c, "cabecera invalida");
+                break;
+            }
+
+            char kind[8];
+            char id[DAEMON_ID_MAX + 1];
+            unsigned long long body_len = 0, hint_len = 0;
+            char extra;
+            if (sscanf(header, "%7s %64s %llu %llu %c", kind, id, &body_len, &hint_len, &extra) != 4 ||
+                !valid_id(id))
+            {
+                send_error(c, "cabecera invalida");
+                break;
+            }
+            bool is_path = strcmp(kind, "PATH") == 0;
+            if (!is_path && strcmp(kind, "DATA") != 0)
+            {
+                send_error(c, "pedido desconocido");
+                break;
+            }
+            if (body_len > (is_path ? DAEMON_PATH_MAX : DAEMON_DATA_MAX) || hint_len > DAEMON_HINT_MAX ||
+                (is_path && body_len == 0))
+            {
+                send_error(c, "pedido demasiado grande");
+                break;
+            }
+
+            request_t *r = new request_t;
+            r->conn = c;
+            strcpy(r->id, id);
+            r->path = nullptr;
+            r->data = nullptr;
+            r->data_len = (size_t)body_len;
+            r->hint = new char[hint_len + 1];
+            r->hint[hint_len] = '\0';
+
+            bool ok;
+            if (is_path)
+            {
+                r->path = new char[body_len + 1];
+                r->path[body_len] = '\0';
+                ok = reader_exact(&rd, (uint8_t *)r->path, (size_t)body_len) &&
+                     strlen(r->path) == body_len;
+            }
+            else
+            {
+                r->data = new uint8_t[body_len ? body_len : 1];
+                ok = reader_exact(&rd, r->data, (size_t)body_len);
+            }
+            ok = ok && reader_exact(&rd, (uint8_t *)r->hint, (size_t)hint_len);
+
+            if (!ok)
+            {
+                request_free(r);
+                break; // conexión cortada a mitad del pedido
+            }
+
+            conn_acquire(c);
+            if (!queue_push(&srv->queue, r))
+            {
+                conn_release(c);
+                request_free(r);
+                break;
+            }
+        }
+
+        delete[] rd.buf;
+
+        {
+            lock_guard<mutex> guard(srv->conns_lock);
+            if (c->prev)
+            {
+                c->prev->next = c->next;
+            }
+            else
+            {
+                srv->conns = c->next;
+            }
+            if (c->next)
+            {
+                c->next->prev = c->prev;
+            }
+            srv->readers--;
+            srv->readers_done.notify_all();
+        }
+        conn_release(c);
+    }
+
+    /**
+     * @brief Crea el socket de escucha en @p path con permisos 0600.
+     *
+     * Reemplaza un socket abandonado por una ejecución anterior, pero no borra otros tipos
+     * de archivo ni el socket de un demonio que sigue escuchando.
+     *
+     * @return Descriptor, o -1 si falla.
+     */
+    int listen_on(const char *path)
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(path) >= sizeof(addr.sun_path))
+        {
+            fprintf(stderr, "Error: la ruta del socket es demasiado larga: %s\n", path);
+            return -1;
+        }
+        strcpy(addr.sun_path, path);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            fprintf(stderr, "Error: no se pudo crear el socket\n");
+            return -1;
+        }
+
+        // Solo se reemplaza el socket de una ejecución anterior; cualquier otro archivo se respeta
+        struct stat st;
+        if (lstat(path, &st) == 0)
+        {
+            if (!S_ISSOCK(st.st_mode))
+            {
+                fprintf(stderr, "Error: %s ya existe y no es un socket\n", path);
+                close(fd);
+                return -1;
+            }
+            // Un socket que acepta conexiones es de otro demonio en marcha
+            int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+            bool alive = probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+            if (probe >= 0)
+            {
+                close(probe);
+            }
+            if (alive)
+            {
+                fprintf(stderr, "Error: ya hay un demonio escuchando en %s\n", path);
+                close(fd);
+                return -1;
+            }
+            unlink(path);
+        }
+
+        // El socket nace con permisos 0600 (umask) y chmod lo asegura donde bind ignora la umask
+        mode_t old_mask = umask(0177);
+        int rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+        umask(old_mask);
+        if (rc < 0 || chmod(path, 0600) < 0 || listen(fd, 64) < 0)
+        {
+            fprintf(stderr, "Error: no se pudo escuchar en %s\n", path);
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    /**
+     * @brief Imprime el uso del modo demonio.
+     */
+    void print_usage(const char *prog)
+    {
+        fprintf(stderr, "Uso: %s --daemon <socket> [-j hilos] [--cache claves|none]\n", prog);
+    }
+
+}
+
+my_error_t daemon_main(int argc, char **argv)
+{
+    const char *sock_path = nullptr;
+    unsigned int n_threads = 0;
+    const char *cache_path = keycache_default_path();
+
+    for (int a = 1; a < argc; a += 2)
+    {
+        const char *opt = argv[a];
+        const char *val = (a + 1 < argc) ? argv[a + 1] : nullptr;
+        if (!val)
+        {
+            print_usage(argv[0]);
+            return ERROR;
+        }
+
+        if (strcmp(opt, "--daemon") == 0)
+        {
+            sock_path = val;
+        }
+        else if (strcmp(opt, "-j") == 0)
+        {
+            n_threads = (unsigned int)strtoul(val, nullptr, 10);
+        }
+        else if (strcmp(opt, "--cache") == 0)
+        {
+            cache_path = strcmp(val, "none") == 0 ? nullptr : val;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return ERROR;
+        }
+    }
+
+    if (!sock_path)
+    {
+        print_usage(argv[0]);
+        return ERROR;
+    }
+    if (n_threads == 0)
+    {
+        n_threads = thread::hardware_concurrency();
+    }
+    if (n_threads == 0)
+    {
+        n_threads = 1;
+    }
+
+    int listen_fd = listen_on(sock_path);
+    if (listen_fd < 0)
+    {
+        return ERROR;
+    }
+
+    // Un cliente que se va a mitad de una respuesta no debe terminar el proceso
+    signal(SIGPIPE, SIG_IGN);
+    stop_requested = 0;
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    keycache_t cache;
+    keycache_load(&cache, cache_path);
+
+    server_t *srv = new server_t;
+    srv->cache = &cache;
+    srv->queue.cap = (size_t)n_threads * DAEMON_QUEUE_PER_WORKER;
+    srv->queue.items = new request_t *[srv->queue.cap];
+    srv->queue.head = 0;
+    srv->queue.count = 0;
+    srv->queue.closed = false;
+    srv->conns = nullptr;
+    srv->readers = 0;
+    srv->n_conns = 0;
+    srv->n_jobs = 0;
+    srv->n_found = 0;
+
+    thread *pool = new thread[n_threads];
+    for (unsigned int t = 0; t < n_threads; t++)
+    {
+        pool[t] = thread(worker_loop, srv);
+    }
+
+    fprintf(stderr, "Escuchando en %s (%u hilos)\n", sock_path, n_threads);
+    auto t0 = chrono::steady_clock::now();
+
+    // ====== Ciclo de aceptación: un lector por conexión ============
+    while (!stop_requested)
+    {
+        struct pollfd pfd = {listen_fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, ACCEPT_POLL_MS);
+        if (ready <= 0)
+        {
+            continue; // tiempo agotado o señal: se revisa stop_requested
+        }
+
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        conn_t *c = new conn_t;
+        c->fd = fd;
+        c->refs = 1; // el lector
+        c->broken = false;
+        c->prev = nullptr;
+        {
+            lock_guard<mutex> guard(srv->conns_lock);
+            c->next = srv->conns;
+            if (srv->conns)
+            {
+                srv->conns->prev = c;
+            }
+            srv->conns = c;
+            srv->readers++;
+        }
+        srv->n_conns.fetch_add(1);
+        thread(reader_loop, srv, c).detach();
+    }
+
+    // ====== Cierre: no se aceptan ni leen más pedidos; se terminan los encolados ============
+    close(listen_fd);
+    unlink(sock_path);
+    {
+        unique_lock<mutex> guard(srv->conns_lock);
+        for (conn_t *c = srv->conns; c; c = c->next)
+        {
+            shutdown(c->fd, SHUT_RD);
+        }
+    }
+
+    // Los lectores frenados por la cola llena siguen entrando a medida que los trabajadores avanzan
+    {
+        unique_lock<mutex> guard(srv->conns_lock);
+        srv->readers_done.wait(guard, [srv]() { return srv->readers == 0; });
+    }
+    queue_close(&srv->queue);
+    for (unsigned int t = 0; t < n_threads; t++)
+    {
+        pool[t].join();
+    }
+    delete[] pool;
+
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    fprintf(stderr, "%zu conexiones, %zu pedidos, %zu resueltos, %.3f s\n",
+            srv->n_conns.load(), srv->n_jobs.load(), srv->n_found.load(), secs);
+
+    delete[] srv->queue.items;
+    delete srv;
+    keycache_free(&cache);
+    return OK;
+}
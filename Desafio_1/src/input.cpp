@@ -0,0 +1,219 @@
+/**
+ * @file input.cpp
+ * @brief Implementación de la capa de entrada por mapeo de memoria
+ *
+ * Este modulo contiene:
+ *      - input_open: Mapea un archivo completo como vista de solo lectura
+ *      - input_open_text: Vista terminada en NUL para la pista
+ *      - input_close: Libera la vista
+ *      - input_prefetch: Lectura anticipada sincrónica (un byte por página)
+ * Ademas cuenta con funciones auxiliares:
+ *      - map_file: mmap + madvise (POSIX)
+ *      - read_whole: Lectura binaria con fread (resto de sistemas)
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <input.hpp>
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define INPUT_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+// long es de 32 bits en Windows: se usan desplazamientos de 64 bits (archivos > 2 GB)
+#define INPUT_FSEEK _fseeki64
+#define INPUT_FTELL _ftelli64
+#else
+#define INPUT_FSEEK fseek
+#define INPUT_FTELL ftell
+#endif
+
+namespace
+{
+    /**
+     * @brief Deja una vista vacía (sin mapeo ni copia).
+     */
+    void view_reset(input_view_t *view)
+    {
+        view->data = nullptr;
+        view->len = 0;
+        view->map_base = nullptr;
+        view->map_len = 0;
+        view->owned = nullptr;
+    }
+
+#ifdef INPUT_MMAP
+    /**
+     * @brief Mapea un archivo completo con una sola apertura.
+     *
+     * @param[in]  path  Ruta al archivo.
+     * @param[out] view  Vista resultante.
+     *
+     * @return `true` si se mapeó un archivo no vacío.
+     */
+    bool map_file(const char *path, input_view_t *view)
+    {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        size_t len = (size_t)st.st_size;
+        void *base = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // el mapeo sigue siendo válido sin el descriptor
+
+        if (base == MAP_FAILED)
+        {
+            return false;
+        }
+
+        // Se recorre de principio a fin: pedir lectura anticipada agresiva
+        madvise(base, len, MADV_SEQUENTIAL);
+        madvise(base, len, MADV_WILLNEED);
+
+        view->data = (const uint8_t *)base;
+        view->len = len;
+        view->map_base = base;
+        view->map_len = len;
+        return true;
+    }
+#else
+    /**
+     * @brief Lee un archivo completo en modo binario con una sola apertura.
+     *
+     * @param[in]  path   Ruta al archivo.
+     * @param[out] view   Vista resultante (con copia propia).
+     * @param[in]  extra  Bytes adicionales en cero al final del buffer.
+     *
+     * @return `true` si se leyó un archivo no vacío.
+     */
+    bool read_whole(const char *path, input_view_t *view, size_t extra)
+    {
+        FILE *f = fopen(path, "rb");
+        if (!f)
+        {
+            return false;
+        }
+
+        if (INPUT_FSEEK(f, 0, SEEK_END) != 0)
+        {
+            fclose(f);
+            return false;
+        }
+        long long sz = INPUT_FTELL(f);
+        if (sz <= 0 || INPUT_FSEEK(f, 0, SEEK_SET) != 0)
+        {
+            fclose(f);
+            return false;
+        }
+
+        uint8_t *buf = new uint8_t[(size_t)sz + extra];
+        size_t r = fread(buf, 1, (size_t)sz, f);
+        fclose(f);
+
+        if (r != (size_t)sz)
+        {
+            delete[] buf;
+            return false;
+        }
+        memset(buf + sz, 0, extra);
+
+        view->data = buf;
+        view->len = (size_t)sz;
+        view->owned = buf;
+        return true;
+    }
+#endif
+
+}
+
+bool input_open(const char *path, input_view_t *view)
+{
+    view_reset(view);
+#ifdef INPUT_MMAP
+    return map_file(path, view);
+#else
+    return read_whole(path, view, 0);
+#endif
+}
+
+bool input_open_text(const char *path, input_view_t *view)
+{
+    view_reset(view);
+#ifdef INPUT_MMAP
+    if (!map_file(path, view))
+    {
+        return false;
+    }
+
+    // El resto de la última página de un mapeo se llena con ceros: si el archivo no
+    // termina justo en un límite de página, data[len] ya es el terminador
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    if (view->len % page != 0)
+    {
+        return true;
+    }
+
+    uint8_t *copy = new uint8_t[view->len + 1];
+    memcpy(copy, view->data, view->len);
+    copy[view->len] = '\0';
+    munmap(view->map_base, view->map_len);
+    view->map_base = nullptr;
+    view->map_len = 0;
+    view->data = copy;
+    view->owned = copy;
+    return true;
+#else
+    return read_whole(path, view, 1);
+#endif
+}
+
+void input_prefetch(const input_view_t *view)
+{
+#ifdef INPUT_MMAP
+    if (!view->map_base)
+    {
+        return; // copia propia: ya está en memoria
+    }
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    const volatile uint8_t *p = view->data;
+    uint8_t sink = 0;
+    for (size_t off = 0; off < view->len; off += page)
+    {
+        sink ^= p[off];
+    }
+    (void)sink;
+#else
+    (void)view;
+#endif
+}
+
+void input_close(input_view_t *view)
+{
+#ifdef INPUT_MMAP
+    if (view->map_base)
+    {
+        munmap(view->map_base, view->map_len);
+    }
+#endif
+    delete[] view->owned;
+    view_reset(view);
+}
@@ -0,0 +1,259 @@
+/**
+ * @file kernels.cpp
+ * @brief Implementación de los kernels vectorizados de desencriptado
+ *
+ * Este modulo contiene:
+ *      - decrypt_into: XOR + rotación a la derecha de un buffer completo
+ *      - decrypt_into_key: XOR con una clave de varios bytes y luego decrypt_into
+ * Ademas cuenta con funciones auxiliares:
+ *      - *_scalar / *_sse2 / *_avx2 / *_avx512: versiones por conjunto de instrucciones
+ *      - select_table: Elige la mejor versión según CPUID
+ *
+ * SSE/AVX no tienen desplazamientos de 8 bits, así que la rotación se arma con
+ * desplazamientos de 16 bits y máscaras por byte:
+ *      ror(v, n) = ((v >> n) & (0xFF >> n)) | ((v << (8 - n)) & (0xFF << (8 - n)))
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <kernels.hpp>
+
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    typedef void (*decrypt_fn_t)(const uint8_t *, uint8_t *, size_t, uint8_t, uint8_t);
+
+    /**
+     * @brief Tabla de kernels de un conjunto de instrucciones.
+     */
+    struct kernel_table_t
+    {
+        kernel_isa_t isa;      /**< Conjunto de instrucciones. */
+        decrypt_fn_t decrypt;  /**< Kernel de desencriptado. */
+    };
+
+    // ====== Versión escalar (referencia) ============
+
+    void decrypt_scalar(const uint8_t *in, uint8_t *out, size_t len, uint8_t n, uint8_t k)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            out[i] = ror_8(in[i] ^ k, n);
+        }
+    }
+
+#ifdef KERNELS_X86
+
+    // ====== SSE2 ============
+
+    __attribute__((target("sse2")))
+    inline __m128i ror_sse2(__m128i v, __m128i cnt_r, __m128i cnt_l, __m128i mask_r, __m128i mask_l)
+    {
+        __m128i r = _mm_and_si128(_mm_srl_epi16(v, cnt_r), mask_r);
+        __m128i l = _mm_and_si128(_mm_sll_epi16(v, cnt_l), mask_l);
+        return _mm_or_si128(r, l);
+    }
+
+    __attribute__((target("sse2")))
+    void decrypt_sse2(const uint8_t *in, uint8_t *out, size_t len, uint8_t n, uint8_t k)
+    {
+        const __m128i key = _mm_set1_epi8((char)k);
+        const __m128i cnt_r = _mm_cvtsi32_si128(n);
+        const __m128i cnt_l = _mm_cvtsi32_si128(8 - n);
+        const __m128i mask_r = _mm_set1_epi8((char)(0xFF >> n));
+        const __m128i mask_l = _mm_set1_epi8((char)(0xFF << (8 - n)));
+
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + i)), key);
+            _mm_storeu_si128((__m128i *)(out + i), ror_sse2(v, cnt_r, cnt_l, mask_r, mask_l));
+        }
+        decrypt_scalar(in + i, out + i, len - i, n, k);
+    }
+
+    // ====== AVX2 ============
+
+    __attribute__((target("avx2")))
+    inline __m256i ror_avx2(__m256i v, __m128i cnt_r, __m128i cnt_l, __m256i mask_r, __m256i mask_l)
+    {
+        __m256i r = _mm256_and_si256(_mm256_srl_epi16(v, cnt_r), mask_r);
+        __m256i l = _mm256_and_si256(_mm256_sll_epi16(v, cnt_l), mask_l);
+        return _mm256_or_si256(r, l);
+    }
+
+    __attribute__((target("avx2")))
+    void decrypt_avx2(const uint8_t *in, uint8_t *out, size_t len, uint8_t n, uint8_t k)
+    {
+        const __m256i key = _mm256_set1_epi8((char)k);
+        const __m128i cnt_r = _mm_cvtsi32_si128(n);
+        const __m128i cnt_l = _mm_cvtsi32_si128(8 - n);
+        const __m256i mask_r = _mm256_set1_epi8((char)(0xFF >> n));
+        const __m256i mask_l = _mm256_set1_epi8((char)(0xFF << (8 - n)));
+
+        size_t i = 0;
+        for (; i + 32 <= len; i += 32)
+        {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(in + i)), key);
+            _mm256_storeu_si256((__m256i *)(out + i), ror_avx2(v, cnt_r, cnt_l, mask_r, mask_l));
+        }
+        decrypt_scalar(in + i, out + i, len - i, n, k);
+    }
+
+    // ====== AVX-512 (BW) ============
+
+    __attribute__((target("avx512f,avx512bw")))
+    inline __m512i ror_avx512(__m512i v, __m128i cnt_r, __m128i cnt_l, __m512i mask_r, __m512i mask_l)
+    {
+        __m512i r = _mm512_and_si512(_mm512_srl_epi16(v, cnt_r), mask_r);
+        __m512i l = _mm512_and_si512(_mm512_sll_epi16(v, cnt_l), mask_l);
+        return _mm512_or_si512(r, l);
+    }
+
+    __attribute__((target("avx512f,avx512bw")))
+    void decrypt_avx512(const uint8_t *in, uint8_t *out, size_t len, uint8_t n, uint8_t k)
+    {
+        const __m512i key = _mm512_set1_epi8((char)k);
+        const __m128i cnt_r = _mm_cvtsi32_si128(n);
+        const __m128i cnt_l = _mm_cvtsi32_si128(8 - n);
+        const __m512i mask_r = _mm512_set1_epi8((char)(0xFF >> n));
+        const __m512i mask_l = _mm512_set1_epi8((char)(0xFF << (8 - n)));
+
+        size_t i = 0;
+        for (; i + 64 <= len; i += 64)
+        {
+            __m512i v = _mm512_xor_si512(_mm512_loadu_si512((const void *)(in + i)), key);
+            _mm512_storeu_si512((void *)(out + i), ror_avx512(v, cnt_r, cnt_l, mask_r, mask_l));
+        }
+        decrypt_scalar(in + i, out + i, len - i, n, k);
+    }
+
+#endif // KERNELS_X86
+
+    const kernel_table_t TABLE_SCALAR = {ISA_SCALAR, decrypt_scalar};
+#ifdef KERNELS_X86
+    const kernel_table_t TABLE_SSE2 = {ISA_SSE2, decrypt_sse2};
+    const kernel_table_t TABLE_AVX2 = {ISA_AVX2, decrypt_avx2};
+    const kernel_table_t TABLE_AVX512 = {ISA_AVX512, decrypt_avx512};
+#endif
+
+    /**
+     * @brief Devuelve la tabla de un conjunto de instrucciones si la CPU lo soporta.
+     *
+     * @param isa Conjunto deseado.
+     * @return Puntero a la tabla, o nullptr si no está disponible.
+     */
+    const kernel_table_t *table_for(kernel_isa_t isa)
+    {
+        switch (isa)
+        {
+        case ISA_SCALAR:
+            return &TABLE_SCALAR;
+#ifdef KERNELS_X86
+        case ISA_SSE2:
+            return __builtin_cpu_supports("sse2") ? &TABLE_SSE2 : nullptr;
+        case ISA_AVX2:
+            return __builtin_cpu_supports("avx2") ? &TABLE_AVX2 : nullptr;
+        case ISA_AVX512:
+            return (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) ? &TABLE_AVX512 : nullptr;
+#endif
+        default:
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief Elige la mejor tabla soportada por la CPU, de la más ancha a la escalar.
+     */
+    const kernel_table_t *select_table()
+    {
+        const kernel_isa_t order[] = {ISA_AVX512, ISA_AVX2, ISA_SSE2, ISA_SCALAR};
+        for (kernel_isa_t isa : order)
+        {
+            const kernel_table_t *t = table_for(isa);
+            if (t)
+            {
+                return t;
+            }
+        }
+        return &TABLE_SCALAR;
+    }
+
+    /**
+     * @brief Tabla activa; se resuelve una sola vez en el primer uso.
+     */
+    atomic<const kernel_table_t *> &active_table()
+    {
+        static atomic<const kernel_table_t *> table(select_table());
+        return table;
+    }
+
+}
+
+void decrypt_into(const uint8_t *in, uint8_t *out, size_t len, uint8_t n, uint8_t k)
+{
+    active_table().load(memory_order_relaxed)->decrypt(in, out, len, n & 7, k);
+}
+
+void decrypt_into_key(const uint8_t *in, uint8_t *out, size_t len, uint8_t n, const uint8_t *key, size_t key_len)
+{
+    // Bloques de un múltiplo de key_len: cada uno empieza en key[0]
+    uint8_t tile[KEY_TILE];
+    size_t tile_len = KEY_TILE - KEY_TILE % key_len;
+    for (size_t i = 0; i < tile_len; i++)
+    {
+        tile[i] = key[i % key_len];
+    }
+
+    for (size_t off = 0; off < len; off += tile_len)
+    {
+        size_t m = len - off < tile_len ? len - off : tile_len;
+        for (size_t i = 0; i < m; i++)
+        {
+            out[off + i] = in[off + i] ^ tile[i];
+        }
+    }
+
+    decrypt_into(out, out, len, n, 0);
+}
+
+kernel_isa_t kernels_active_isa()
+{
+    return active_table().load()->isa;
+}
+
+bool kernels_force_isa(kernel_isa_t isa)
+{
+    const kernel_table_t *t = table_for(isa);
+    if (!t)
+    {
+        return false;
+    }
+    active_table().store(t);
+    return true;
+}
+
+const char *kernels_isa_name(kernel_isa_t isa)
+{
+    switch (isa)
+    {
+    case ISA_SSE2:
+        return "sse2";
+    case ISA_AVX2:
+        return "avx2";
+    case ISA_AVX512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
@@ -0,0 +1,361 @@
+/**
+ * @file keycache.cpp
+ * @brief Implementación de la caché persistente de claves resueltas
+ *
+ * Este modulo contiene:
+ *      - content_hash: Hash de 64 bits con cuatro acumuladores independientes
+ *      - keycache_load / keycache_store: Lectura y escritura del archivo de la caché
+ *      - keycache_lookup / keycache_recent: Consultas
+ *      - finder_cached: Caché por hash, claves recientes y búsqueda completa
+ * Ademas cuenta con funciones auxiliares:
+ *      - cache_append: Agrega una entrada al arreglo en memoria
+ *      - recent_touch: Mueve una clave al frente de las recientes
+ *      - is_clean_text: Filtro de los aciertos con claves recientes
+ *      - entry_cand: Índice de candidato de una entrada
+ *      - mix: Ronda de mezcla del hash
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <keycache.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <cinttypes>
+
+using namespace std;
+
+namespace
+{
+    // Constantes de mezcla (primos de 64 bits con bits bien repartidos)
+    const uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+
+    /**
+     * @brief Ronda de mezcla: incorpora la palabra @p w al acumulador @p acc.
+     */
+    inline uint64_t mix(uint64_t acc, uint64_t w)
+    {
+        acc += w * PRIME_2;
+        acc = (acc << 31) | (acc >> 33);
+        return acc * PRIME_1;
+    }
+
+    /**
+     * @brief Agrega una entrada al final del arreglo (crece al doble).
+     */
+    void cache_append(keycache_t *c, const keycache_entry_t *e)
+    {
+        if (c->count == c->cap)
+        {
+            size_t newcap = c->cap ? 2 * c->cap : 64;
+            keycache_entry_t *p = new keycache_entry_t[newcap];
+            if (c->items)
+            {
+                memcpy(p, c->items, c->count * sizeof(keycache_entry_t));
+                delete[] c->items;
+            }
+            c->items = p;
+            c->cap = newcap;
+        }
+        c->items[c->count++] = *e;
+    }
+
+    /**
+     * @brief Pone el candidato @p cand al frente de las claves recientes (sin repetir).
+     */
+    void recent_touch(keycache_t *c, uint16_t cand)
+    {
+        size_t i = 0;
+        while (i < c->n_recent && c->recent[i] != cand)
+        {
+            i++;
+        }
+        if (i == c->n_recent && c->n_recent < KEYCACHE_RECENT)
+        {
+            c->n_recent++;
+        }
+        if (i == KEYCACHE_RECENT)
+        {
+            i = KEYCACHE_RECENT - 1; // se descarta la más antigua
+        }
+        for (; i > 0; i--)
+        {
+            c->recent[i] = c->recent[i - 1];
+        }
+        c->recent[0] = cand;
+    }
+
+    /**
+     * @brief Indica si @p msg es texto limpio: ASCII imprimible, espacios en blanco o UTF-8 válido.
+     *
+     * Una clave reciente se prueba fuera del orden (n, k) de la búsqueda completa; con una
+     * pista corta puede producir basura que contiene la pista por casualidad. Esa basura
+     * casi nunca es UTF-8 válido, así que el acierto se descarta y decide la búsqueda completa.
+     */
+    bool is_clean_text(const char *msg)
+    {
+        const uint8_t *p = (const uint8_t *)msg;
+        while (*p)
+        {
+            uint8_t c = *p;
+            if (c < 0x80)
+            {
+                if (c < 0x20 && c != '\n' && c != '\r' && c != '\t')
+                {
+                    return false;
+                }
+                p++;
+                continue;
+            }
+
+            // Secuencia UTF-8: byte inicial y 1 a 3 bytes de continuación
+            size_t extra = (c >= 0xC2 && c <= 0xDF) ? 1 : (c >= 0xE0 && c <= 0xEF) ? 2 : (c >= 0xF0 && c <= 0xF4) ? 3 : 0;
+            if (extra == 0)
+            {
+                return false;
+            }
+            for (size_t i = 1; i <= extra; i++)
+            {
+                if ((p[i] & 0xC0) != 0x80)
+                {
+                    return false;
+                }
+            }
+            p += extra + 1;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Índice de candidato de una entrada.
+     */
+    inline uint16_t entry_cand(const keycache_entry_t *e)
+    {
+        return (uint16_t)((e->n - ROT_MIN) * KEY_SPACE + e->k);
+    }
+
+}
+
+uint64_t content_hash(const uint8_t *buf, size_t len)
+{
+    // Cuatro acumuladores independientes: el procesador encadena las multiplicaciones
+    // en paralelo y el costo queda cerca del ancho de banda de memoria
+    uint64_t v[4] = {PRIME_1 + PRIME_2, PRIME_2, 0, (uint64_t)0 - PRIME_1};
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32)
+    {
+        for (int l = 0; l < 4; l++)
+        {
+            uint64_t w;
+            memcpy(&w, buf + i + 8 * l, 8);
+            v[l] = mix(v[l], w);
+        }
+    }
+
+    uint64_t h = ((v[0] << 1) | (v[0] >> 63)) + ((v[1] << 7) | (v[1] >> 57)) +
+                 ((v[2] << 12) | (v[2] >> 52)) + ((v[3] << 18) | (v[3] >> 46));
+    h += (uint64_t)len;
+
+    // Resto: palabras de 8 bytes y luego bytes sueltos
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t w;
+        memcpy(&w, buf + i, 8);
+        h ^= mix(0, w);
+        h = ((h << 27) | (h >> 37)) * PRIME_1 + PRIME_3;
+    }
+    for (; i < len; i++)
+    {
+        h ^= buf[i] * PRIME_3;
+        h = ((h << 11) | (h >> 53)) * PRIME_1;
+    }
+
+    // Avalancha final
+    h ^= h >> 33;
+    h *= PRIME_2;
+    h ^= h >> 29;
+    h *= PRIME_3;
+    h ^= h >> 32;
+    return h;
+}
+
+const char *keycache_default_path()
+{
+    const char *env = getenv(KEYCACHE_ENV);
+    if (env && strcmp(env, "none") == 0)
+    {
+        return nullptr;
+    }
+    return (env && *env) ? env : KEYCACHE_FILE;
+}
+
+void keycache_load(keycache_t *c, const char *path)
+{
+    c->path = nullptr;
+    c->items = nullptr;
+    c->count = 0;
+    c->cap = 0;
+    c->n_recent = 0;
+
+    if (!path)
+    {
+        return;
+    }
+
+    c->path = new char[strlen(path) + 1];
+    strcpy(c->path, path);
+
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        return; // todavía no existe: se crea con la primera clave
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+        keycache_entry_t e;
+        uint64_t len;
+        unsigned int n, k;
+        char method[8];
+
+        if (sscanf(line, "%" SCNx64 " %" SCNu64 " %u %u %7s", &e.hash, &len, &n, &k, method) != 5 ||
+            n < ROT_MIN || n > ROT_MAX || k >= KEY_SPACE ||
+            (strcmp(method, "RLE") != 0 && strcmp(method, "LZ78") != 0))
+        {
+            continue; // línea mal formada
+        }
+
+        e.len = len;
+        e.n = (uint8_t)n;
+        e.k = (uint8_t)k;
+        e.lz78 = method[0] == 'L';
+        cache_append(c, &e);
+
+        // Las últimas líneas del archivo son las claves más recientes
+        recent_touch(c, entry_cand(&e));
+    }
+    fclose(f);
+}
+
+void keycache_free(keycache_t *c)
+{
+    delete[] c->items;
+    delete[] c->path;
+    c->items = nullptr;
+    c->path = nullptr;
+    c->count = 0;
+    c->cap = 0;
+    c->n_recent = 0;
+}
+
+bool keycache_lookup(keycache_t *c, uint64_t hash, uint64_t len, keycache_entry_t *out)
+{
+    lock_guard<mutex> guard(c->lock);
+
+    // De la más nueva a la más vieja: la última línea de un hash es la que vale
+    for (size_t i = c->count; i > 0; i--)
+    {
+        const keycache_entry_t &e = c->items[i - 1];
+        if (e.hash == hash && e.len == len)
+        {
+            *out = e;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool keycache_store(keycache_t *c, const keycache_entry_t *e)
+{
+    lock_guard<mutex> guard(c->lock);
+
+    cache_append(c, e);
+    recent_touch(c, entry_cand(e));
+
+    if (!c->path)
+    {
+        return true;
+    }
+
+    FILE *f = fopen(c->path, "a");
+    if (!f)
+    {
+        fprintf(stderr, "Error: no se pudo escribir la caché %s\n", c->path);
+        return false;
+    }
+    fprintf(f, "%016" PRIx64 " %" PRIu64 " %u %u %s\n", e->hash, e->len, (unsigned)e->n, (unsigned)e->k,
+            e->lz78 ? "LZ78" : "RLE");
+    return fclose(f) == 0;
+}
+
+size_t keycache_recent(keycache_t *c, uint16_t *out)
+{
+    lock_guard<mutex> guard(c->lock);
+
+    for (size_t i = 0; i < c->n_recent; i++)
+    {
+        out[i] = c->recent[i];
+    }
+    return c->n_recent;
+}
+
+bool finder_cached(keycache_t *c, const uint8_t *enc, size_t enc_len, const char *know_fragment,
+                   char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k, unsigned int n_threads)
+{
+    if (!c || enc_len == 0)
+    {
+        return finder_auto(enc, enc_len, know_fragment, out_msg, out_method, out_n, out_k, n_threads);
+    }
+
+    uint64_t hash = content_hash(enc, enc_len);
+
+    // 1. El mismo archivo ya se resolvió: una sola clave
+    keycache_entry_t hit;
+    if (keycache_lookup(c, hash, enc_len, &hit))
+    {
+        uint16_t cand = entry_cand(&hit);
+        if (finder_keys(enc, enc_len, know_fragment, &cand, 1, out_msg, out_method, out_n, out_k))
+        {
+            lock_guard<mutex> guard(c->lock);
+            recent_touch(c, cand);
+            return true;
+        }
+    }
+
+    // 2. Claves reutilizadas: las más recientes primero, solo si dan texto limpio. Se
+    //    prefiere una clave ya probada aunque otra anterior en el orden (n, k) también confirme
+    uint16_t recent[KEYCACHE_RECENT];
+    size_t n_recent = keycache_recent(c, recent);
+
+    bool found = finder_keys(enc, enc_len, know_fragment, recent, n_recent, out_msg, out_method, out_n, out_k);
+    if (found && !is_clean_text(*out_msg))
+    {
+        delete[] *out_msg;
+        delete[] *out_method;
+        *out_msg = nullptr;
+        found = false;
+    }
+
+    // 3. Búsqueda completa
+    if (!found && !finder_auto(enc, enc_len, know_fragment, out_msg, out_method, out_n, out_k, n_threads))
+    {
+        return false;
+    }
+
+    keycache_entry_t e;
+    e.hash = hash;
+    e.len = enc_len;
+    e.n = *out_n;
+    e.k = *out_k;
+    e.lz78 = strcmp(*out_method, "LZ78") == 0;
+    keycache_store(c, &e);
+    return true;
+}
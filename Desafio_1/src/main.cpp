@@ -20,10 +20,13 @@
  *
  * Inicia el programa y delega la ejecución a `app_main`.
  *
+ * @param argc Cantidad de argumentos.
+ * @param argv Argumentos; si hay alguno se usa el modo por lotes (ver @ref batch.hpp).
+ *
  * @return 0 si la aplicación terminó correctamente.
  * @return 1 si ocurrió algún error.
  */
-int main()
+int main(int argc, char *argv[])
 {
     // app_main devuelve my_error_t:
     // - OK (1) → éxito
@@ -32,5 +35,5 @@ int main()
     // Se convierte a valor de retorno estándar:
     //  - 0 → éxito (convención UNIX)
     //  - 1 → error
-    return app_main() ? 0 : 1;
+    return app_main(argc, argv) ? 0 : 1;
 }
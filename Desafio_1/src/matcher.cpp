@@ -0,0 +1,320 @@
+/**
+ * @file matcher.cpp
+ * @brief Implementación de la búsqueda de la pista en el texto descifrado
+ *
+ * Este modulo contiene:
+ *      - matcher_init: Separa las alternativas y construye la tabla de Horspool y el autómata
+ *      - matcher_find: memchr + memcmp, Horspool o autómata según la pista
+ *      - matcher_feed: Autómata sobre un texto por bloques
+ * Ademas cuenta con funciones auxiliares:
+ *      - build_automaton: Aho-Corasick sobre clases de bytes
+ *      - find_single: Búsqueda de una sola alternativa en un texto completo
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <matcher.hpp>
+
+#include <cstring>
+
+namespace
+{
+    // Transición aún no definida durante la construcción del trie
+    const uint32_t NO_STATE = 0xFFFFFFFFu;
+
+    // El prefiltro con memchr se abandona si en promedio hay un falso candidato cada
+    // MEMCHR_MIN_GAP bytes (el primer byte de la pista es demasiado común en el texto)
+    const size_t MEMCHR_MIN_GAP = 16;
+    const size_t MEMCHR_GRACE = 64;
+
+    /**
+     * @brief Construye el autómata de Aho-Corasick de todas las alternativas.
+     *
+     * Primero arma el trie y después, en orden BFS, completa cada transición faltante con
+     * la del estado de fallo: el resultado es un autómata determinista, así que la búsqueda
+     * hace exactamente un acceso a la tabla por byte.
+     */
+    void build_automaton(hint_matcher_t *m)
+    {
+        size_t total = 0;
+        for (size_t a = 0; a < m->n_pats; a++)
+        {
+            total += m->lens[a];
+        }
+
+        size_t max_states = total + 1;
+        size_t nc = m->n_cls;
+        m->next = new uint32_t[max_states * nc];
+        m->accept = new bool[max_states]();
+        for (size_t i = 0; i < max_states * nc; i++)
+        {
+            m->next[i] = NO_STATE;
+        }
+        m->n_states = 1;
+
+        // Trie
+        for (size_t a = 0; a < m->n_pats; a++)
+        {
+            uint32_t st = 0;
+            for (size_t i = 0; i < m->lens[a]; i++)
+            {
+                uint32_t &t = m->next[st * nc + m->cls[(uint8_t)m->pats[a][i]]];
+                if (t == NO_STATE)
+                {
+                    t = (uint32_t)m->n_states++;
+                }
+                st = t;
+            }
+            m->accept[st] = true;
+        }
+
+        // Enlaces de fallo en orden BFS (la cola son los mismos estados, en orden de visita)
+        uint32_t *fail = new uint32_t[m->n_states];
+        uint32_t *queue = new uint32_t[m->n_states];
+        size_t q_head = 0, q_tail = 0;
+
+        fail[0] = 0;
+        for (size_t c = 0; c < nc; c++)
+        {
+            uint32_t &t = m->next[c];
+            if (t == NO_STATE)
+            {
+                t = 0;
+            }
+            else
+            {
+                fail[t] = 0;
+                queue[q_tail++] = t;
+            }
+        }
+
+        while (q_head < q_tail)
+        {
+            uint32_t s = queue[q_head++];
+            m->accept[s] = m->accept[s] || m->accept[fail[s]];
+            for (size_t c = 0; c < nc; c++)
+            {
+                uint32_t &t = m->next[s * nc + c];
+                uint32_t via_fail = m->next[fail[s] * nc + c];
+                if (t == NO_STATE)
+                {
+                    t = via_fail;
+                }
+                else
+                {
+                    fail[t] = via_fail;
+                    queue[q_tail++] = t;
+                }
+            }
+        }
+
+        delete[] queue;
+        delete[] fail;
+    }
+
+    /**
+     * @brief Busca la única alternativa en un texto completo.
+     *
+     * `memchr` salta hasta el siguiente primer byte de la pista y `memcmp` confirma. Si los
+     * falsos candidatos son demasiados (primer byte muy frecuente), el resto del texto se
+     * recorre con Horspool, que salta según el último byte de cada ventana.
+     */
+    bool find_single(const hint_matcher_t *m, const char *text, size_t len)
+    {
+        const char *p = m->pats[0];
+        size_t plen = m->lens[0];
+        if (len < plen)
+        {
+            return false;
+        }
+        if (plen == 1)
+        {
+            return memchr(text, p[0], len) != nullptr;
+        }
+
+        size_t last = len - plen; // última posición donde cabe la pista
+        size_t pos = 0;
+        size_t misses = 0;
+
+        while (pos <= last)
+        {
+            const char *q = (const char *)memchr(text + pos, p[0], last - pos + 1);
+            if (!q)
+            {
+                return false;
+            }
+            if (memcmp(q + 1, p + 1, plen - 1) == 0)
+            {
+                return true;
+            }
+            pos = (size_t)(q - text) + 1;
+
+            if (++misses > MEMCHR_GRACE && misses * MEMCHR_MIN_GAP > pos)
+            {
+                break;
+            }
+        }
+
+        // Horspool desde donde quedó el prefiltro
+        char tail = p[plen - 1];
+        while (pos <= last)
+        {
+            char c = text[pos + plen - 1];
+            if (c == tail && memcmp(text + pos, p, plen - 1) == 0)
+            {
+                return true;
+            }
+            pos += m->shift[(uint8_t)c];
+        }
+        return false;
+    }
+
+}
+
+void matcher_init(hint_matcher_t *m, const char *hint)
+{
+    size_t hint_len = strlen(hint);
+    m->copy = new char[hint_len + 1];
+    memcpy(m->copy, hint, hint_len + 1);
+
+    size_t max_lines = 1;
+    for (size_t i = 0; i < hint_len; i++)
+    {
+        max_lines += hint[i] == '\n';
+    }
+    m->pats = new const char *[max_lines];
+    m->lens = new size_t[max_lines];
+    m->n_pats = 0;
+    m->max_len = 0;
+
+    // Sin cabecera la pista completa (con sus saltos de línea) es una sola alternativa
+    size_t head_len = strlen(MATCHER_ALT_HEADER);
+    bool multi = strncmp(hint, MATCHER_ALT_HEADER, head_len) == 0 &&
+                 (hint[head_len] == '\n' || (hint[head_len] == '\r' && hint[head_len + 1] == '\n'));
+    if (!multi)
+    {
+        if (hint_len > 0)
+        {
+            m->pats[0] = m->copy;
+            m->lens[0] = hint_len;
+            m->n_pats = 1;
+            m->max_len = hint_len;
+        }
+    }
+    else
+    {
+        // Una alternativa por línea; cada una queda terminada en NUL dentro de la copia
+        char *line = strchr(m->copy, '\n') + 1;
+        for (;;)
+        {
+            char *end = strchr(line, '\n');
+            bool last_line = (end == nullptr);
+            if (last_line)
+            {
+                end = m->copy + hint_len;
+            }
+            char *eol = end;
+            if (end > line && end[-1] == '\r')
+            {
+                end--;
+            }
+            size_t len = (size_t)(end - line);
+            if (len > 0)
+            {
+                m->pats[m->n_pats] = line;
+                m->lens[m->n_pats] = len;
+                m->n_pats++;
+                m->max_len = len > m->max_len ? len : m->max_len;
+            }
+            *end = '\0';
+            if (last_line)
+            {
+                break;
+            }
+            line = eol + 1;
+        }
+    }
+
+    // Horspool: distancia desde la última aparición de cada byte hasta el final de la pista
+    size_t plen = m->n_pats == 1 ? m->lens[0] : 1;
+    for (int b = 0; b < 256; b++)
+    {
+        m->shift[b] = plen;
+    }
+    for (size_t i = 0; i + 1 < plen; i++)
+    {
+        m->shift[(uint8_t)m->pats[0][i]] = plen - 1 - i;
+    }
+
+    // Clases de bytes: cada byte de la pista tiene la suya; el resto comparte la 0
+    memset(m->cls, 0, sizeof(m->cls));
+    m->n_cls = 1;
+    for (size_t a = 0; a < m->n_pats; a++)
+    {
+        for (size_t i = 0; i < m->lens[a]; i++)
+        {
+            uint8_t c = (uint8_t)m->pats[a][i];
+            if (m->cls[c] == 0)
+            {
+                m->cls[c] = (uint8_t)m->n_cls++;
+            }
+        }
+    }
+
+    build_automaton(m);
+}
+
+void matcher_free(hint_matcher_t *m)
+{
+    delete[] m->copy;
+    delete[] m->pats;
+    delete[] m->lens;
+    delete[] m->next;
+    delete[] m->accept;
+    m->copy = nullptr;
+    m->pats = nullptr;
+    m->lens = nullptr;
+    m->next = nullptr;
+    m->accept = nullptr;
+}
+
+bool matcher_find(const hint_matcher_t *m, const char *text, size_t len)
+{
+    if (m->n_pats == 0)
+    {
+        return true; // la pista vacía siempre está contenida
+    }
+    if (m->n_pats == 1)
+    {
+        return find_single(m, text, len);
+    }
+
+    uint32_t state = 0;
+    return matcher_feed(m, &state, text, len);
+}
+
+bool matcher_feed(const hint_matcher_t *m, uint32_t *state, const char *chunk, size_t len)
+{
+    const uint32_t *next = m->next;
+    const bool *accept = m->accept;
+    const uint8_t *cls = m->cls;
+    size_t nc = m->n_cls;
+    uint32_t st = *state;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        st = next[st * nc + cls[(uint8_t)chunk[i]]];
+        if (accept[st])
+        {
+            *state = st;
+            return true;
+        }
+    }
+
+    *state = st;
+    return false;
+}
@@ -0,0 +1,359 @@
+/**
+ * @file output.cpp
+ * @brief Implementación de la escritura de los mensajes recuperados
+ *
+ * Este modulo contiene:
+ *      - output_writev: writev con reintentos (POSIX)
+ *      - output_stdout: Bloques a la salida estándar
+ *      - output_init / output_open_dir / output_open_archive / output_close: Destinos
+ *      - output_make_dirs: Crea una carpeta y las que le faltan en la ruta
+ *      - output_message_name: Nombre del archivo de un mensaje
+ *      - output_message: Un archivo por mensaje o pwrite en el archivo único
+ * Ademas cuenta con funciones auxiliares:
+ *      - pwrite_all: pwrite con reintentos (POSIX)
+ *      - message_path: Ruta del archivo de un mensaje dentro de la carpeta
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <output.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/stat.h>
+#ifdef OUTPUT_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <direct.h>
+#endif
+
+namespace
+{
+#ifdef OUTPUT_POSIX
+    /**
+     * @brief Escribe @p len bytes en @p fd a partir de @p off, reintentando las escrituras parciales.
+     */
+    bool pwrite_all(int fd, const char *buf, size_t len, uint64_t off)
+    {
+        while (len > 0)
+        {
+            ssize_t w = pwrite(fd, buf, len, (off_t)off);
+            if (w < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            buf += w;
+            len -= (size_t)w;
+            off += (uint64_t)w;
+        }
+        return true;
+    }
+#endif
+
+    /**
+     * @brief Ruta del mensaje de @p enc_path dentro de @p dir (liberar con `delete[]`).
+     */
+    char *message_path(const char *dir, const char *enc_path)
+    {
+        char *name = output_message_name(enc_path);
+        size_t dlen = strlen(dir);
+        bool sep = dlen > 0 && dir[dlen - 1] != '/' && dir[dlen - 1] != '\\';
+
+        char *path = new char[dlen + sep + strlen(name) + 1];
+        strcpy(path, dir);
+        if (sep)
+        {
+            strcat(path, "/");
+        }
+        strcat(path, name);
+        delete[] name;
+        return path;
+    }
+
+}
+
+#ifdef OUTPUT_POSIX
+bool output_writev(int fd, output_iov_t *iov, int n_iov)
+{
+    while (n_iov > 0)
+    {
+        ssize_t w = writev(fd, iov, n_iov);
+        if (w < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        size_t done = (size_t)w;
+        while (n_iov > 0 && done >= iov->iov_len)
+        {
+            done -= iov->iov_len;
+            iov++;
+            n_iov--;
+        }
+        if (n_iov > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+    return true;
+}
+#endif
+
+bool output_stdout(output_iov_t *iov, int n_iov)
+{
+#ifdef OUTPUT_POSIX
+    // Lo que ya está en el buffer de stdout debe salir antes que los bloques
+    if (fflush(stdout) != 0)
+    {
+        return false;
+    }
+    return output_writev(STDOUT_FILENO, iov, n_iov);
+#else
+    for (int i = 0; i < n_iov; i++)
+    {
+        if (fwrite(iov[i].iov_base, 1, iov[i].iov_len, stdout) != iov[i].iov_len)
+        {
+            return false;
+        }
+    }
+    return fflush(stdout) == 0;
+#endif
+}
+
+bool output_make_dirs(const char *dir)
+{
+    size_t len = strlen(dir);
+    char *buf = new char[len + 1];
+    strcpy(buf, dir);
+
+    // Cada prefijo que termina en un separador, y al final la ruta completa
+    for (size_t i = 1; i <= len; i++)
+    {
+        if (i < len && buf[i] != '/' && buf[i] != '\\')
+        {
+            continue;
+        }
+        char c = buf[i];
+        buf[i] = '\0';
+#ifdef _WIN32
+        _mkdir(buf);
+#else
+        mkdir(buf, 0755);
+#endif
+        buf[i] = c;
+    }
+    delete[] buf;
+
+    struct stat st;
+    return stat(dir, &st) == 0 && (st.st_mode & S_IFMT) == S_IFDIR;
+}
+
+char *output_message_name(const char *enc_path)
+{
+    const char *base = enc_path;
+    for (const char *q = enc_path; *q; q++)
+    {
+        if (*q == '/' || *q == '\\')
+        {
+            base = q + 1;
+        }
+    }
+
+    // Último `Encriptado` del nombre
+    const char *word = "Encriptado";
+    const char *hit = nullptr;
+    for (const char *q = strstr(base, word); q; q = strstr(q + 1, word))
+    {
+        hit = q;
+    }
+
+    size_t blen = strlen(base);
+    if (!hit)
+    {
+        char *name = new char[blen + strlen(".mensaje") + 1];
+        strcpy(name, base);
+        strcat(name, ".mensaje");
+        return name;
+    }
+
+    size_t pre = (size_t)(hit - base);
+    char *name = new char[blen - strlen(word) + strlen("mensaje") + 1];
+    memcpy(name, base, pre);
+    strcpy(name + pre, "mensaje");
+    strcat(name, hit + strlen(word));
+    return name;
+}
+
+void output_init(output_t *o)
+{
+    o->kind = OUTPUT_NONE;
+    o->dir = nullptr;
+#ifdef OUTPUT_POSIX
+    o->fd = -1;
+#else
+    o->file = nullptr;
+#endif
+    o->offset = 0;
+    o->index = nullptr;
+}
+
+bool output_open_dir(output_t *o, const char *dir)
+{
+    output_init(o);
+
+    if (!output_make_dirs(dir))
+    {
+        fprintf(stderr, "Error: no se pudo crear la carpeta %s\n", dir);
+        return false;
+    }
+
+    o->dir = new char[strlen(dir) + 1];
+    strcpy(o->dir, dir);
+    o->kind = OUTPUT_DIR;
+    return true;
+}
+
+bool output_open_archive(output_t *o, const char *path)
+{
+    output_init(o);
+
+#ifdef OUTPUT_POSIX
+    o->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (o->fd < 0)
+#else
+    o->file = fopen(path, "wb");
+    if (!o->file)
+#endif
+    {
+        fprintf(stderr, "Error: no se pudo crear %s\n", path);
+        return false;
+    }
+
+    char *index_path = new char[strlen(path) + strlen(OUTPUT_INDEX_EXT) + 1];
+    strcpy(index_path, path);
+    strcat(index_path, OUTPUT_INDEX_EXT);
+    o->index = fopen(index_path, "w");
+    if (!o->index)
+    {
+        fprintf(stderr, "Error: no se pudo crear %s\n", index_path);
+        delete[] index_path;
+#ifdef OUTPUT_POSIX
+        close(o->fd);
+        o->fd = -1;
+#else
+        fclose(o->file);
+        o->file = nullptr;
+#endif
+        return false;
+    }
+    delete[] index_path;
+
+    o->kind = OUTPUT_ARCHIVE;
+    return true;
+}
+
+bool output_message(output_t *o, const char *enc_path, const char *msg, size_t len)
+{
+    if (o->kind == OUTPUT_DIR)
+    {
+        char *path = message_path(o->dir, enc_path);
+#ifdef OUTPUT_POSIX
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            fprintf(stderr, "Error: no se pudo crear %s\n", path);
+            delete[] path;
+            return false;
+        }
+
+        output_iov_t iov = {(void *)msg, len};
+        bool ok = output_writev(fd, &iov, 1);
+        ok = close(fd) == 0 && ok;
+#else
+        FILE *f = fopen(path, "wb");
+        if (!f)
+        {
+            fprintf(stderr, "Error: no se pudo crear %s\n", path);
+            delete[] path;
+            return false;
+        }
+
+        bool ok = fwrite(msg, 1, len, f) == len;
+        ok = fclose(f) == 0 && ok;
+#endif
+        if (!ok)
+        {
+            fprintf(stderr, "Error: no se pudo escribir %s\n", path);
+        }
+        delete[] path;
+        return ok;
+    }
+
+    if (o->kind == OUTPUT_ARCHIVE)
+    {
+#ifdef OUTPUT_POSIX
+        // Se reserva el tramo bajo el candado; la escritura va fuera, en paralelo con las demás
+        uint64_t off;
+        {
+            std::lock_guard<std::mutex> guard(o->lock);
+            off = o->offset;
+            o->offset += len;
+            fprintf(o->index, "%llu %zu %s\n", (unsigned long long)off, len, enc_path);
+        }
+        bool ok = pwrite_all(o->fd, msg, len, off);
+#else
+        // Sin pwrite: el mensaje se agrega al final dentro del candado
+        bool ok;
+        {
+            std::lock_guard<std::mutex> guard(o->lock);
+            fprintf(o->index, "%llu %zu %s\n", (unsigned long long)o->offset, len, enc_path);
+            o->offset += len;
+            ok = fwrite(msg, 1, len, o->file) == len;
+        }
+#endif
+        if (!ok)
+        {
+            fprintf(stderr, "Error: no se pudo escribir el mensaje de %s\n", enc_path);
+            return false;
+        }
+        return true;
+    }
+
+    return true;
+}
+
+bool output_close(output_t *o)
+{
+    bool ok = true;
+    if (o->kind == OUTPUT_ARCHIVE)
+    {
+        // Se cierran los dos aunque falle el primero
+#ifdef OUTPUT_POSIX
+        ok = close(o->fd) == 0;
+#else
+        ok = fclose(o->file) == 0;
+#endif
+        ok = fclose(o->index) == 0 && ok;
+        if (!ok)
+        {
+            fprintf(stderr, "Error: no se pudo terminar de escribir los mensajes\n");
+        }
+    }
+    delete[] o->dir;
+    output_init(o);
+    return ok;
+}
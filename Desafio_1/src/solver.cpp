@@ -4,10 +4,30 @@
  *
  * Este modulo contiene:
  *      - finder: Metodo de busqueda por medio de fuerza bruta
+ *      - finder_parallel: Busqueda de fuerza bruta repartida entre varios hilos
+ *      - finder_known_plaintext: Recuperación de (n, k) a partir del fragmento conocido
+ *      - finder_auto: Texto conocido primero y fuerza bruta como respaldo
+ *      - finder_keys: Prueba solo una lista de combinaciones (claves guardadas en caché)
+ *      - finder_stream: Búsqueda por bloques con memoria acotada
+ *      - finder_multikey / detect_key_length: Claves XOR de varios bytes, columna por columna
  * Ademas cuenta con funciones auxiliares:
  *      - decrypt_buffer: Aplica las operaciones de bits para el desencriptado del texto
+ *      - encrypt_buffer: Operación inversa (rotación a la izquierda y luego XOR)
+ *      - encrypt_buffer_key: Igual que encrypt_buffer con una clave de varios bytes
+ *      - byte_histogram: Cuenta la frecuencia de cada valor de byte del texto cifrado
  *      - printable_ratio: Analiza el porcentaje del imprimible del texto para evitar analizar texto basura
- *      - contains_substr: Busca en el texto desencriptado si hay coincidencias con la pista
+ *      - prefilter_candidates: Descarta con el histograma los (n, k) que no alcanzan RATIO_MIN
+ *      - symbol_histogram / rank_candidates: Ordena los candidatos del más al menos probable
+ *      - frag_pattern_t / frag_matcher_t: Búsqueda de la pista (matcher.hpp) sobre salida por bloques
+ *      - rle_match_compressed: Busca el fragmento sobre los triples RLE sin expandirlos
+ *      - scratch_t / warm_slot_t: Memoria de trabajo por hilo, reutilizada entre candidatos y entre búsquedas
+ *      - try_decrypted / try_candidate: Prueban un buffer desencriptado o una combinación (n, k)
+ *      - try_list: Prueba en orden una lista de candidatos
+ *      - kpa_mark_rle / kpa_mark_lz78: Candidatos consistentes con el fragmento y el formato
+ *      - stream_reader_t / stream_try_candidate / stream_write: Etapas del modo por bloques
+ *      - column_histograms / coincidence_index: Detección de la longitud de la clave
+ *      - key_from_histograms / key_fill_high / key_fill_counts / lz78_low_options: Clave byte por byte
+ *      - try_key: Prueba una clave de varios bytes completa
  *
  * @authors Julián Sánchez
  *          Jaider Bedoya
@@ -16,202 +36,1941 @@
  * @version 1.0
  */
 
-#include <solver.hpp>
+#include <solver_internal.hpp>
 
-namespace
+#include <algorithm>
+
+uint8_t *decrypt_buffer(const uint8_t *in, size_t len, uint8_t n, uint8_t k)
+{
+    uint8_t *out = new uint8_t[len];
+
+    // La inversa de la XOR es una XOR, y para invertir la rotación a la izquierda... se rota a la derecha!
+    decrypt_into(in, out, len, n, k);
+
+    return out;
+}
+
+uint8_t *encrypt_buffer(const uint8_t *in, size_t len, uint8_t n, uint8_t k)
+{
+    uint8_t *out = new uint8_t[len];
+
+    // rol(v, n) ^ k == ror(v ^ ror(k, n), 8 - n): se reutiliza el kernel vectorizado de desencriptado
+    decrypt_into(in, out, len, (uint8_t)(8 - n), ror_8(k, n));
+
+    return out;
+}
+
+uint8_t *encrypt_buffer_key(const uint8_t *in, size_t len, uint8_t n, const uint8_t *key, size_t key_len)
+{
+    uint8_t *out = new uint8_t[len];
+
+    // rol(v, n) = ror(v, 8 - n); después la XOR con la clave repetida
+    decrypt_into(in, out, len, (uint8_t)(8 - n), 0);
+    for (size_t i = 0; i < len; i++)
+    {
+        out[i] ^= key[i % key_len];
+    }
+
+    return out;
+}
+
+void byte_histogram(const uint8_t *buf, size_t len, size_t hist[256])
+{
+    for (int b = 0; b < 256; b++)
+    {
+        hist[b] = 0;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        hist[buf[i]]++;
+    }
+}
+
+bool printable_ratio(const size_t hist[256], size_t len, uint8_t n, uint8_t k, double min_ratio)
+{
+    if (len == 0)
+    {
+        return false;
+    }
+
+    double cnt = 0;
+
+    for (int b = 0; b < 256; b++)
+    {
+        uint8_t d = ror_8((uint8_t)(b ^ k), n);
+        if (d >= 32 && d <= 126)
+        { // cuantos de esos simbolos presentes en el texto son ASCII imprimibles?
+            cnt += (double)hist[b];
+        }
+    }
+
+    double ratio = cnt / (double)len; // Razon de cuantos simbolos son imprimibles para evitar analizar texto basura
+
+    return (ratio >= min_ratio);
+}
+
+size_t prefilter_candidates(const uint8_t *enc, size_t enc_len, uint16_t *out_cands)
 {
+    TRACE_BEGIN(t0);
+
+    size_t hist[256];
+    byte_histogram(enc, enc_len, hist);
+    size_t count = prefilter_from_histogram(hist, enc_len, out_cands);
+
+    TRACE_END(TRACE_PREFILTER, t0, enc_len, N_CANDIDATES - count);
+    return count;
+}
+
+size_t prefilter_from_histogram(const size_t hist[256], size_t enc_len, uint16_t *out_cands)
+{
+    size_t count = 0;
+    for (size_t c = 0; c < N_CANDIDATES; c++)
+    {
+        uint8_t n = (uint8_t)(ROT_MIN + c / KEY_SPACE);
+        uint8_t k = (uint8_t)(c % KEY_SPACE);
+
+        if (printable_ratio(hist, enc_len, n, k, RATIO_MIN))
+        {
+            out_cands[count++] = (uint16_t)c;
+        }
+    }
+
+    return count;
+}
 
+namespace
+{
     /**
-     * @brief Desencripta un buffer de datos aplicando una operación XOR y una rotación a la derecha.
+     * @brief Peso de un carácter según su frecuencia esperada en un texto en español.
      *
-     * Esta función toma un buffer de entrada encriptado, aplica la operación XOR con la clave `k`
-     * y luego rota cada byte `n` posiciones a la derecha, generando un nuevo buffer desencriptado.
-     *
-     * @param in   Puntero al buffer de entrada encriptado.
-     * @param len  Longitud en bytes del buffer de entrada.
-     * @param n    Número de bits a rotar hacia la derecha en cada byte.
-     * @param k    Valor de la clave utilizada en la operación XOR.
+     * Espacio y vocales pesan más, las letras poco usadas menos, los caracteres de control
+     * restan y los bytes altos (UTF-8) son neutros.
+     */
+    int symbol_weight(uint8_t c)
+    {
+        if (c == ' ')
+        {
+            return 9;
+        }
+        if (c >= 'a' && c <= 'z')
+        {
+            if (strchr("ea", c))
+            {
+                return 8;
+            }
+            if (strchr("osrni", c))
+            {
+                return 7;
+            }
+            if (strchr("dlctu", c))
+            {
+                return 6;
+            }
+            return strchr("jzxkw", c) ? 2 : 4;
+        }
+        if (c >= 'A' && c <= 'Z')
+        {
+            return 2;
+        }
+        if (c == '\n' || c == '.' || c == ',')
+        {
+            return 3;
+        }
+        if (c >= 32 && c <= 126)
+        {
+            return 1; // dígitos y demás signos
+        }
+        if (c == '\r' || c == '\t')
+        {
+            return 1;
+        }
+        return (c >= 0x80 || c == '\0') ? 0 : -6;
+    }
+
+
+    /**
+     * @struct frag_pattern_t
+     * @brief Pista preprocesada una sola vez por archivo (buscador y corridas de cada alternativa).
      *
-     * @return Puntero a un nuevo buffer dinámico con los datos desencriptados.
-     *         El usuario es responsable de liberar la memoria con `delete[]`.
+     * Es de solo lectura durante la búsqueda, así que todos los hilos la comparten.
+     */
+    struct frag_pattern_t
+    {
+        hint_matcher_t hm;  /**< Buscador de la pista (todas las alternativas). */
+        char *run_sym;      /**< Símbolo de cada corrida; las alternativas van seguidas. */
+        size_t *run_cnt;    /**< Longitud de cada corrida. */
+        size_t *run_off;    /**< Primera corrida de cada alternativa. */
+        size_t *n_runs;     /**< Cantidad de corridas de cada alternativa. */
+        size_t max_runs;    /**< Mayor cantidad de corridas (tamaño de la ventana RLE). */
+    };
+
+    /**
+     * @brief Prepara el buscador y las corridas de cada alternativa de la pista.
      *
-     * @note La función utiliza `new[]` para reservar memoria.
-     *       Asegúrese de liberar el buffer resultante para evitar fugas de memoria.
+     * @param[out] p     Patrón a inicializar; liberar con `pattern_free()`.
+     * @param[in]  frag  Pista (una alternativa por línea).
      */
-    uint8_t *decrypt_buffer(const uint8_t *in, size_t len, uint8_t n, uint8_t k)
+    void pattern_init(frag_pattern_t *p, const char *frag)
     {
-        uint8_t *out = new uint8_t[len];
+        matcher_init(&p->hm, frag);
 
-        for (size_t i = 0; i < len; i++)
+        size_t total = 0;
+        for (size_t a = 0; a < p->hm.n_pats; a++)
         {
-            uint8_t tmp = in[i] ^ k; // La inversa de la XOR es una XOR ajsdjas
-            out[i] = ror_8(tmp, n);  // para invertir la rotación a la izquierda... se rota a la derecha!
+            total += p->hm.lens[a];
         }
 
-        return out;
+        // Secuencia de corridas (símbolo, longitud) para buscar en el dominio RLE
+        p->run_sym = new char[total + 1];
+        p->run_cnt = new size_t[total + 1];
+        p->run_off = new size_t[p->hm.n_pats + 1];
+        p->n_runs = new size_t[p->hm.n_pats + 1];
+        p->max_runs = 0;
+
+        size_t r = 0;
+        for (size_t a = 0; a < p->hm.n_pats; a++)
+        {
+            const char *alt = p->hm.pats[a];
+            p->run_off[a] = r;
+            for (size_t i = 0; i < p->hm.lens[a]; i++)
+            {
+                if (r > p->run_off[a] && p->run_sym[r - 1] == alt[i])
+                {
+                    p->run_cnt[r - 1]++;
+                }
+                else
+                {
+                    p->run_sym[r] = alt[i];
+                    p->run_cnt[r] = 1;
+                    r++;
+                }
+            }
+            p->n_runs[a] = r - p->run_off[a];
+            p->max_runs = p->n_runs[a] > p->max_runs ? p->n_runs[a] : p->max_runs;
+        }
     }
 
     /**
-     * @brief Evalúa si un buffer contiene una proporción suficiente de caracteres ASCII imprimibles.
-     *
-     * Recorre el buffer y calcula la proporción de caracteres comprendidos en el rango ASCII imprimible (32–126).
-     * Retorna verdadero si la proporción de caracteres imprimibles es mayor o igual al umbral `min_ratio`.
+     * @brief Libera la memoria de un patrón.
+     */
+    void pattern_free(frag_pattern_t *p)
+    {
+        matcher_free(&p->hm);
+        delete[] p->run_sym;
+        delete[] p->run_cnt;
+        delete[] p->run_off;
+        delete[] p->n_runs;
+        p->run_sym = nullptr;
+        p->run_cnt = nullptr;
+        p->run_off = nullptr;
+        p->n_runs = nullptr;
+    }
+
+    /**
+     * @struct frag_matcher_t
+     * @brief Estado de búsqueda del fragmento sobre una salida que llega por bloques.
      *
-     * @param buf        Puntero al buffer a analizar.
-     * @param len        Longitud del buffer en bytes.
-     * @param min_ratio  Proporción mínima aceptada (entre 0.0 y 1.0).
+     * El estado del autómata se conserva entre bloques, así que la pista se encuentra aunque
+     * quede partida entre dos bloques. Como en los mensajes completos, el texto termina en
+     * el primer byte NUL.
+     */
+    struct frag_matcher_t
+    {
+        const frag_pattern_t *pat;      /**< Patrón compartido. */
+        uint32_t state;                 /**< Estado del autómata de `matcher_feed()`. */
+        bool found;                     /**< Se encontró el fragmento. */
+        const atomic<size_t> *best;     /**< Mejor posición hallada por otro hilo (o nullptr). */
+        size_t index;                   /**< Posición del candidato actual en la lista. */
+    };
+
+    /**
+     * @brief Reinicia el buscador para un candidato nuevo.
      *
-     * @return `true` si el buffer cumple con la proporción mínima de caracteres imprimibles,
-     *         `false` en caso contrario o si `len` es cero.
+     * @param m      Buscador.
+     * @param pat    Patrón compartido.
+     * @param best   Mejor posición de la búsqueda paralela, o nullptr en la búsqueda serial.
+     * @param index  Posición del candidato; si `*best` baja de aquí, el candidato se abandona.
+     */
+    void matcher_start(frag_matcher_t *m, const frag_pattern_t *pat, const atomic<size_t> *best, size_t index)
+    {
+        m->pat = pat;
+        m->state = 0;
+        m->found = (pat->hm.n_pats == 0); // la pista vacía siempre está contenida
+        m->best = best;
+        m->index = index;
+    }
+
+    /**
+     * @brief Sink de los decodificadores incrementales: avanza la búsqueda con un bloque.
      *
-     * @warning Si `len` es cero, la función imprime un mensaje de error y retorna `false`.
+     * @return `false` (detener el decodificador) si ya se encontró el fragmento, si el texto
+     *         terminó en un NUL o si otro hilo encontró un candidato anterior.
      */
-    bool printable_ratio(const uint8_t *buf, size_t len, double min_ratio)
+    bool matcher_sink(const char *chunk, size_t len, void *user)
     {
+        frag_matcher_t *m = (frag_matcher_t *)user;
 
-        if (len == 0)
+        if (m->found)
         {
-            cout << "ERROR, No hay nada texto para analizar.\n";
             return false;
         }
+        if (m->best && m->best->load(memory_order_relaxed) < m->index)
+        {
+            return false; // cancelado: ya hay una coincidencia en un candidato anterior
+        }
 
-        double cnt = 0;
+        // El texto termina en el primer NUL, igual que strlen()
+        const char *nul = (const char *)memchr(chunk, 0, len);
+        size_t n = nul ? (size_t)(nul - chunk) : len;
 
-        for (size_t i = 0; i < len; i++)
+        if (matcher_feed(&m->pat->hm, &m->state, chunk, n))
         {
-            if (buf[i] >= 32 && buf[i] <= 126)
-            { // cuantos de esos simbolos presentes en el texto son ASCII imprimibles?
-                cnt++;
-            }
+            m->found = true;
+            return false;
         }
+        return nul == nullptr;
+    }
+
+    /**
+     * @struct scratch_t
+     * @brief Memoria de trabajo de un hilo de búsqueda.
+     *
+     * Se reserva una vez por búsqueda (tamaño según `enc_len` y el fragmento) y se reutiliza
+     * en cada candidato, así que el ciclo de búsqueda no hace reservas de memoria: solo el
+     * ganador reserva su mensaje. Al terminar la búsqueda el hilo la conserva (`warm_slot_t`)
+     * para la siguiente.
+     */
+    typedef struct {
+        uint8_t *dec;           /**< Buffer desencriptado. */
+        size_t dec_cap;         /**< Capacidad de `dec`. */
+        char *win_sym;          /**< Ventana de corridas de `rle_match_compressed()`. */
+        size_t *win_cnt;        /**< Longitudes de la ventana de corridas. */
+        size_t win_cap;         /**< Capacidad de la ventana. */
+        lz78_stream_t ls;       /**< Decodificador LZ78 incremental (diccionario reutilizado). */
+    } scratch_t;
 
-        double ratio = cnt / (double)len; // Razon de cuantos simbolos son imprimibles para evitar analizar texto basura
+    // Buffer desencriptado más grande que un hilo conserva entre búsquedas
+    const size_t SCRATCH_WARM_MAX = (size_t)64 << 20;
 
-        return (ratio >= min_ratio);
+    /**
+     * @brief Libera la memoria de trabajo.
+     */
+    void scratch_release(scratch_t *s)
+    {
+        delete[] s->dec;
+        delete[] s->win_sym;
+        delete[] s->win_cnt;
+        lz78_stream_free(&s->ls);
     }
 
     /**
-     * @brief Verifica si una cadena contiene una subcadena dada.
+     * @struct warm_slot_t
+     * @brief Memoria de trabajo que un hilo conserva entre búsquedas.
      *
-     * Implementa una búsqueda secuencial de la subcadena `part` dentro del texto `text`.
+     * Los hilos de larga vida (grupo del modo por lotes, trabajadores del demonio) resuelven
+     * un archivo tras otro: con el buffer, la ventana y el diccionario LZ78 ya reservados,
+     * una búsqueda nueva no pide memoria salvo que el archivo sea más grande que los anteriores.
+     */
+    struct warm_slot_t
+    {
+        bool valid;     /**< Hay memoria guardada. */
+        scratch_t s;    /**< Memoria guardada. */
+
+        ~warm_slot_t()
+        {
+            if (valid)
+            {
+                scratch_release(&s);
+            }
+        }
+    };
+
+    thread_local warm_slot_t warm_scratch = {false, {}};
+
+    /**
+     * @brief Prepara la memoria de trabajo para buscar @p pat en un texto cifrado de @p enc_len bytes.
      *
-     * @param text  Cadena de texto principal donde buscar.
-     * @param part  Subcadena que se desea localizar.
+     * Toma la memoria que el hilo conservó de su búsqueda anterior y solo agranda lo que no alcanza.
+     */
+    void scratch_init(scratch_t *s, size_t enc_len, const frag_pattern_t *pat)
+    {
+        if (warm_scratch.valid)
+        {
+            *s = warm_scratch.s;
+            warm_scratch.valid = false;
+        }
+        else
+        {
+            s->dec = nullptr;
+            s->dec_cap = 0;
+            s->win_sym = nullptr;
+            s->win_cnt = nullptr;
+            s->win_cap = 0;
+            lz78_stream_init(&s->ls);
+        }
+
+        if (s->dec_cap < enc_len)
+        {
+            delete[] s->dec;
+            s->dec = new uint8_t[enc_len];
+            s->dec_cap = enc_len;
+        }
+
+        size_t win = pat->max_runs + 1;
+        if (s->win_cap < win)
+        {
+            delete[] s->win_sym;
+            delete[] s->win_cnt;
+            s->win_sym = new char[win];
+            s->win_cnt = new size_t[win];
+            s->win_cap = win;
+        }
+    }
+
+    /**
+     * @brief Devuelve la memoria de trabajo al hilo (o la libera si es demasiado grande).
+     */
+    void scratch_free(scratch_t *s)
+    {
+        if (!warm_scratch.valid && s->dec_cap <= SCRATCH_WARM_MAX)
+        {
+            warm_scratch.s = *s;
+            warm_scratch.valid = true;
+            return;
+        }
+        scratch_release(s);
+    }
+
+    /**
+     * @brief Busca la pista directamente sobre los triples RLE, sin expandirlos.
      *
-     * @return `true` si `part` se encuentra dentro de `text`,
-     *         `false` si no existe coincidencia o si los punteros son nulos.
+     * Los triples se agrupan en corridas maximales (se unen triples consecutivos con el mismo
+     * símbolo y se ignoran los de cero repeticiones) y se comparan con las corridas de cada
+     * alternativa: las interiores deben coincidir exactamente y las de los extremos solo
+     * necesitan una longitud mayor o igual. Como en los mensajes completos, el texto termina
+     * en la primera corrida de NUL.
      *
-     * @warning Si `text` o `part` son punteros nulos, se imprime un mensaje de error y se retorna `false`.
-     * @warning Si la longitud de `part` es mayor que la de `text`, la función imprime un mensaje de error y retorna `false`.
+     * @param dec   Buffer desencriptado (triples RLE).
+     * @param len   Longitud del buffer.
+     * @param m     Buscador con el patrón; se marca `found` si hay coincidencia.
+     * @param s     Memoria de trabajo (ventana de corridas).
      *
-     * @note La búsqueda distingue entre mayúsculas y minúsculas (case-sensitive).
+     * @return `true` si el fragmento aparece en el texto que produciría la expansión.
      */
-    bool contains_substr(const char *text, const char *part)
+    bool rle_match_compressed(const uint8_t *dec, size_t len, frag_matcher_t *m, scratch_t *s)
     {
-        if (!text || !part)
+        const frag_pattern_t *p = m->pat;
+        if (m->found)
         {
-            cout << "Error, punteros nulos\n";
-            return false;
+            return true;
         }
 
-        size_t text_len = strlen(text);
-        size_t part_len = strlen(part);
+        size_t cap = p->max_runs;
+
+        // Últimas max_runs corridas completas del texto (buffer circular)
+        char *win_sym = s->win_sym;
+        size_t *win_cnt = s->win_cnt;
+        size_t win_fill = 0;
+        size_t win_head = 0;
+
+        char cur_sym = '\0';
+        size_t cur_cnt = 0;
+        size_t n_triples = len / 3;
+
+        // Verifica si las últimas corridas de la ventana emparejan a la alternativa a
+        auto window_matches = [&](size_t a) -> bool
+        {
+            size_t nr = p->n_runs[a];
+            if (win_fill < nr)
+            {
+                return false;
+            }
+            const char *sym = p->run_sym + p->run_off[a];
+            const size_t *cnt = p->run_cnt + p->run_off[a];
+            size_t first = win_head + win_fill - nr;
+            for (size_t t = 0; t < nr; t++)
+            {
+                size_t w = (first + t) % cap;
+                if (win_sym[w] != sym[t])
+                {
+                    return false;
+                }
+                bool edge = (t == 0 || t == nr - 1);
+                if (edge ? win_cnt[w] < cnt[t] : win_cnt[w] != cnt[t])
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
 
-        if (part_len > text_len)
+        // Agrega la corrida en curso a la ventana y revisa si completa una coincidencia
+        auto close_run = [&]() -> bool
         {
-            // Es molesto obtener esto a la salida a pesar de que encuentra el texto original
-            //cout << "Error. Pista más grande que el texto original.\n";
+            if (cur_cnt == 0)
+            {
+                return false;
+            }
+            if (win_fill < cap)
+            {
+                win_sym[(win_head + win_fill) % cap] = cur_sym;
+                win_cnt[(win_head + win_fill) % cap] = cur_cnt;
+                win_fill++;
+            }
+            else
+            {
+                win_sym[win_head] = cur_sym;
+                win_cnt[win_head] = cur_cnt;
+                win_head = (win_head + 1) % cap;
+            }
+            for (size_t a = 0; a < p->hm.n_pats; a++)
+            {
+                if (window_matches(a))
+                {
+                    return true;
+                }
+            }
             return false;
-        }
+        };
 
-        for (size_t i = 0; i + part_len <= text_len; i++)
+        for (size_t t = 0; t < n_triples && !m->found; t++)
         {
-            size_t k = 0;
+            // Revisar de vez en cuando si otro hilo ya ganó con un candidato anterior
+            if ((t & 4095) == 0 && m->best && m->best->load(memory_order_relaxed) < m->index)
+            {
+                break;
+            }
+
+            uint8_t count = dec[3 * t + 1];
+            char sym = (char)dec[3 * t + 2];
 
-            // Comparar carácter por carácter
-            while (k < part_len && text[i + k] == part[k])
+            if (count == 0)
+            {
+                continue; // no produce texto
+            }
+            if (cur_cnt > 0 && sym == cur_sym)
             {
-                k++;
+                cur_cnt += count;
+                continue;
             }
 
-            // Si recorrimos todo el patrón, encontramos coincidencia
-            if (k == part_len)
+            m->found = close_run();
+            if (sym == '\0')
             {
-                return true;
+                cur_cnt = 0; // fin del texto, igual que strlen()
+                break;
             }
+            cur_sym = sym;
+            cur_cnt = count;
         }
 
-        return false;
-    }
+        if (!m->found)
+        {
+            m->found = close_run();
+        }
 
-}
+        return m->found;
+    }
 
-bool finder(const uint8_t *enc, size_t enc_len, const char *know_fragment, char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k)
-{
+    /**
+     * @brief Busca la pista en un buffer ya desencriptado.
+     *
+     * Clasifica el flujo con `classify_stream()`: un flujo que no es RLE
+     * plausible ni LZ78 válido se descarta sin decodificar nada. Según la clase, busca el
+     * fragmento en el dominio comprimido de RLE (`rle_match_compressed()`) o decodificando
+     * LZ78 de forma incremental; ambos solo si el flujo es ambiguo. La búsqueda
+     * se detiene en cuanto aparece el fragmento, cuando el flujo resulta inválido o cuando
+     * otro hilo ya ganó con un candidato anterior. Solo el candidato ganador se descomprime
+     * completo, una vez confirmada la coincidencia.
+     *
+     * @param[in]  dec            Buffer desencriptado.
+     * @param[in]  enc_len        Longitud del buffer.
+     * @param[in]  pat            Fragmento conocido preprocesado.
+     * @param[in]  best           Mejor posición de la búsqueda paralela (nullptr si es serial).
+     * @param[in]  index          Posición de este candidato en la lista de búsqueda.
+     * @param[in]  s              Memoria de trabajo del hilo.
+     * @param[out] out_msg        Mensaje descomprimido si hubo coincidencia (liberar con `delete[]`).
+     * @param[out] out_method     Nombre estático del método que produjo la coincidencia.
+     *
+     * @return `true` si el candidato descifra un mensaje que contiene el fragmento.
+     */
+    bool try_decrypted(const uint8_t *dec, size_t enc_len, const frag_pattern_t *pat,
+                       const atomic<size_t> *best, size_t index,
+                       scratch_t *s, char **out_msg, const char **out_method)
+    {
+        // Una pasada barata sobre los triples decide qué decodificador vale la pena correr
+        TRACE_BEGIN(t_cls);
+        codec_class_t cls = classify_stream(dec, enc_len);
+        TRACE_END(TRACE_CLASSIFY, t_cls, enc_len, cls == CODEC_NONE);
 
-    *out_msg = nullptr;
+        frag_matcher_t m;
+        m.found = false;
 
-    // ciclos de busqueda
-    for (uint8_t n = 1; n <= 7; n++)
-    { // busqueda del n
-        for (unsigned int k = 0; k < 256; k++)
-        { // busqueda del k
+        // RLE: buscar el fragmento sobre los triples, sin expandir
+        if (cls & CODEC_RLE)
+        {
+            TRACE_BEGIN(t_rm);
+            matcher_start(&m, pat, best, index);
+            rle_match_compressed(dec, enc_len, &m, s);
+            TRACE_END(TRACE_RLE_MATCH, t_rm, enc_len, !m.found);
+        }
 
-            // desencriptar cada posible combinación de n y k
-            uint8_t *dec = decrypt_buffer(enc, enc_len, n, (uint8_t)k);
+        if (m.found)
+        {
+            // Solo el ganador se materializa completo
+            TRACE_BEGIN(t_re);
+            char *rle = rle_decompress_parallel(dec, enc_len, 0);
+            size_t rle_len = rle ? strlen(rle) : 0;
+            TRACE_END(TRACE_RLE_EXPAND, t_re, rle_len, !rle);
 
-            if (!dec)
+            TRACE_BEGIN(t_rv);
+            bool ok = rle && matcher_find(&pat->hm, rle, rle_len);
+            TRACE_END(TRACE_VERIFY, t_rv, rle_len, !ok);
+            if (ok)
             {
-                continue; // si retorna un nullptr pasa al siguiente k
+                *out_msg = rle;
+                *out_method = "RLE";
+                return true;
             }
-            if (!printable_ratio(dec, enc_len, RATIO_MIN))
+            delete[] rle;
+        }
+
+        // si llegamos aqui es porque no era RLE
+        // LZ78: el clasificador ya verificó todos los índices
+        m.found = false;
+        if (cls & CODEC_LZ78)
+        {
+            matcher_start(&m, pat, best, index);
+        }
+        if (!m.found && (cls & CODEC_LZ78))
+        {
+            TRACE_BEGIN(t_ls);
+            lz78_stream_t *ls = &s->ls;
+            lz78_stream_reset(ls);
+            stream_status_t st = lz78_stream_feed(ls, dec, enc_len, matcher_sink, &m);
+            if (st == STREAM_MORE)
             {
-                delete[] dec; // ese dec no sirvió
-                continue;     // pasamos al siguiente valor de k
+                st = lz78_stream_finish(ls, matcher_sink, &m);
             }
+            TRACE_END(TRACE_LZ78_STREAM, t_ls, ls->out_len, st == STREAM_INVALID);
+        }
 
-            // Si todo sale bien... desencriptemos!
-            // RLE
-            char *rle = rle_decompress(dec, enc_len);
+        if (m.found)
+        {
+            // Para mensajes muy grandes el ganador se decodifica en paralelo
+            TRACE_BEGIN(t_le);
+            char *lz = lz78_decompress_parallel(dec, enc_len, 0);
+            size_t lz_len = lz ? strlen(lz) : 0;
+            TRACE_END(TRACE_LZ78_EXPAND, t_le, lz_len, !lz);
 
-            if (rle)
+            TRACE_BEGIN(t_lv);
+            bool ok = lz && matcher_find(&pat->hm, lz, lz_len);
+            TRACE_END(TRACE_VERIFY, t_lv, lz_len, !ok);
+            if (ok)
             {
-                if (contains_substr(rle, know_fragment))
-                {
-                    *out_msg = rle;
-                    *out_method = new char[4];
-                    strcpy(*out_method, "RLE");
-                    *out_n = n;
-                    *out_k = (uint8_t)k;
-
-                    delete[] dec;
-                    return true;
-                }
-                delete[] rle;
+                *out_msg = lz;
+                *out_method = "LZ78";
+                return true;
             }
+            delete[] lz;
+        }
 
-            // si llegamos aqui es porque no era RLE
-            // LZ78
-            char *lz = lz78_decompress(dec, enc_len);
-            if (lz)
-            {
-                if (contains_substr(lz, know_fragment))
-                {
-                    *out_msg = lz;
-                    *out_method = new char[6];
-                    strcpy(*out_method, "LZ78");
-                    *out_n = n;
-                    *out_k = (uint8_t)k;
+        return false;
+    }
 
-                    delete[] dec;
-                    return true;
-                }
+    /**
+     * @brief Prueba una única combinación de rotación @p n y clave @p k.
+     *
+     * Desencripta sobre el buffer reutilizable del hilo y sigue con `try_decrypted()`.
+     * El porcentaje de imprimibles ya fue verificado por `prefilter_candidates()`.
+     *
+     * @param[in]  enc            Buffer encriptado.
+     * @param[in]  enc_len        Longitud del buffer encriptado.
+     * @param[in]  pat            Fragmento conocido preprocesado.
+     * @param[in]  n              Rotación a probar.
+     * @param[in]  k              Clave XOR a probar.
+     * @param[in]  best           Mejor posición de la búsqueda paralela (nullptr si es serial).
+     * @param[in]  index          Posición de este candidato en la lista de búsqueda.
+     * @param[in]  s              Memoria de trabajo del hilo.
+     * @param[out] out_msg        Mensaje descomprimido si hubo coincidencia (liberar con `delete[]`).
+     * @param[out] out_method     Nombre estático del método que produjo la coincidencia.
+     *
+     * @return `true` si el candidato descifra un mensaje que contiene el fragmento.
+     */
+    bool try_candidate(const uint8_t *enc, size_t enc_len, const frag_pattern_t *pat,
+                       uint8_t n, uint8_t k, const atomic<size_t> *best, size_t index,
+                       scratch_t *s, char **out_msg, const char **out_method)
+    {
+        // desencriptar la combinación de n y k sobre el buffer reutilizable
+        TRACE_BEGIN(t_dec);
+        decrypt_into(enc, s->dec, enc_len, n, k);
+        TRACE_END(TRACE_DECRYPT, t_dec, enc_len, 0);
+
+        return try_decrypted(s->dec, enc_len, pat, best, index, s, out_msg, out_method);
+    }
+
+    /**
+     * @brief Copia el nombre del método a un buffer dinámico para el llamador.
+     *
+     * @param method Nombre estático del método ("RLE" o "LZ78").
+     * @return Copia en memoria dinámica; el llamador la libera con `delete[]`.
+     */
+    char *dup_method(const char *method)
+    {
+        char *out = new char[strlen(method) + 1];
+        strcpy(out, method);
+        return out;
+    }
+
+    /**
+     * @brief Prueba los candidatos @p cands en orden y se detiene en el primero que confirma la pista.
+     *
+     * @return `true` si algún candidato descifró y descomprimió un mensaje con el fragmento.
+     */
+    bool try_list(const uint8_t *enc, size_t enc_len, const char *know_fragment, const uint16_t *cands, size_t n_cands,
+                  char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k)
+    {
+        frag_pattern_t pat;
+        pattern_init(&pat, know_fragment);
+
+        scratch_t scratch;
+        scratch_init(&scratch, enc_len, &pat);
 
-                delete[] lz;
+        bool found = false;
+        for (size_t i = 0; i < n_cands && !found; i++)
+        {
+            uint8_t n = (uint8_t)(ROT_MIN + cands[i] / KEY_SPACE);
+            uint8_t k = (uint8_t)(cands[i] % KEY_SPACE);
+
+            char *msg = nullptr;
+            const char *method = nullptr;
+
+            if (try_candidate(enc, enc_len, &pat, n, k, nullptr, i, &scratch, &msg, &method))
+            {
+                *out_msg = msg;
+                *out_method = dup_method(method);
+                *out_n = n;
+                *out_k = k;
+                found = true;
             }
-            delete[] dec;
         }
+
+        scratch_free(&scratch);
+        pattern_free(&pat);
+        return found;
     }
 
-    return false;
+    /**
+     * @brief Marca los candidatos LZ78 consistentes con la estructura del texto cifrado.
+     *
+     * El primer token de LZ78 no puede referenciar el diccionario (está vacío), así que
+     * sus dos bytes de índice descifran a 0. Como `rol_8(0, n) = 0` para todo n, la clave
+     * queda fijada a `k = enc[0]` (y exige `enc[1] == enc[0]`). La rotación se filtra
+     * pidiendo que todos los caracteres del fragmento aparezcan en la columna de símbolos.
+     *
+     * @param[in]     enc       Buffer encriptado.
+     * @param[in]     enc_len   Longitud del buffer encriptado.
+     * @param[in]     frag      Fragmento conocido.
+     * @param[in]     sym_hist  Histograma de la columna de símbolos (posiciones 3i + 2).
+     * @param[in,out] marks     Arreglo de N_CANDIDATES banderas; se marcan los consistentes.
+     */
+    void kpa_mark_lz78(const uint8_t *enc, size_t enc_len, const char *frag,
+                       const size_t sym_hist[256], bool *marks)
+    {
+        if (enc_len < 3 || enc[0] != enc[1])
+        {
+            return;
+        }
+
+        uint8_t k = enc[0];
+        for (uint8_t n = ROT_MIN; n <= ROT_MAX; n++)
+        {
+            bool ok = true;
+            for (const char *p = frag; *p && ok; p++)
+            {
+                ok = sym_hist[rol_8((uint8_t)*p, n) ^ k] > 0;
+            }
+            if (ok)
+            {
+                marks[(n - ROT_MIN) * KEY_SPACE + k] = true;
+            }
+        }
+    }
+
+    /**
+     * @brief Marca los candidatos RLE consistentes con el fragmento conocido.
+     *
+     * El fragmento se reduce a su secuencia de símbolos de corrida s0..s(m-1) (sin repetir
+     * consecutivos). En un flujo RLE esos símbolos aparecen en triples consecutivos, es decir,
+     * existe j con `sym[j + t] = rol_8(s_t, n) ^ k`. La XOR entre dos posiciones elimina k:
+     * `sym[j] ^ sym[j + t] == rol_8(s0, n) ^ rol_8(s_t, n)`, de modo que cada posición que
+     * cumple la ecuación fija `k = sym[j] ^ rol_8(s0, n)` sin probar las 256 claves.
+     *
+     * Los símbolos cifrados consecutivos iguales se colapsan antes de comparar, porque una
+     * corrida de más de 255 caracteres se codifica en varios triples con el mismo símbolo.
+     *
+     * @param[in]     enc       Buffer encriptado.
+     * @param[in]     enc_len   Longitud del buffer encriptado.
+     * @param[in]     frag      Fragmento conocido.
+     * @param[in,out] marks     Arreglo de N_CANDIDATES banderas; se marcan los consistentes.
+     */
+    void kpa_mark_rle(const uint8_t *enc, size_t enc_len, const char *frag, bool *marks)
+    {
+        size_t frag_len = strlen(frag);
+        size_t n_triples = enc_len / 3;
+        if (frag_len == 0 || n_triples == 0)
+        {
+            return;
+        }
+
+        // Secuencia de símbolos de corrida del fragmento
+        uint8_t *runs = new uint8_t[frag_len];
+        size_t m = 0;
+        for (size_t i = 0; i < frag_len; i++)
+        {
+            if (m == 0 || runs[m - 1] != (uint8_t)frag[i])
+            {
+                runs[m++] = (uint8_t)frag[i];
+            }
+        }
+
+        // Columna de símbolos cifrados con los consecutivos iguales colapsados
+        uint8_t *col = new uint8_t[n_triples];
+        size_t col_len = 0;
+        for (size_t j = 0; j < n_triples; j++)
+        {
+            uint8_t e = enc[3 * j + 2];
+            if (col_len == 0 || col[col_len - 1] != e)
+            {
+                col[col_len++] = e;
+            }
+        }
+
+        uint8_t *diff = new uint8_t[m];
+        for (uint8_t n = ROT_MIN; n <= ROT_MAX; n++)
+        {
+            uint8_t r0 = rol_8(runs[0], n);
+            for (size_t t = 0; t < m; t++)
+            {
+                diff[t] = r0 ^ rol_8(runs[t], n);
+            }
+
+            for (size_t j = 0; j + m <= col_len; j++)
+            {
+                size_t t = 1;
+                while (t < m && (uint8_t)(col[j] ^ col[j + t]) == diff[t])
+                {
+                    t++;
+                }
+                if (t == m)
+                {
+                    marks[(n - ROT_MIN) * KEY_SPACE + (col[j] ^ r0)] = true;
+                }
+            }
+        }
+
+        delete[] diff;
+        delete[] col;
+        delete[] runs;
+    }
+
+    // ====== Modo por bloques ============
+
+    /**
+     * @struct stream_reader_t
+     * @brief Lectura por bloques del archivo cifrado con memoria acotada.
+     *
+     * El primer bloque (a lo sumo STREAM_PROBE bytes) se guarda aparte y se reutiliza en
+     * cada recorrido: es el único que ven casi todas las claves equivocadas.
+     */
+    typedef struct {
+        FILE *f;            /**< Archivo cifrado. */
+        uint8_t *head;      /**< Primer bloque, leído una sola vez. */
+        size_t head_len;    /**< Longitud del primer bloque. */
+        fpos_t body;        /**< Posición del archivo justo después del primer bloque. */
+        uint8_t *enc;       /**< Bloque cifrado actual. */
+        uint8_t *dec;       /**< Bloque desencriptado actual. */
+        size_t chunk;       /**< Tamaño de los bloques siguientes (múltiplo de 3). */
+    } stream_reader_t;
+
+    /**
+     * @brief Abre el archivo y reparte @p mem_cap entre los bloques.
+     *
+     * @param[out] r        Lector; liberar con `reader_close()`.
+     * @param[in]  path     Ruta del archivo cifrado.
+     * @param[in]  mem_cap  Memoria disponible para los bloques.
+     *
+     * @return `true` si se pudo abrir el archivo.
+     */
+    bool reader_open(stream_reader_t *r, const char *path, size_t mem_cap)
+    {
+        r->f = fopen(path, "rb");
+        if (!r->f)
+        {
+            fprintf(stderr, "Error: no se pudo abrir el archivo %s\n", path);
+            return false;
+        }
+        // Los bloques ya son grandes: sin el buffer interno de stdio se evita una copia
+        setvbuf(r->f, nullptr, _IONBF, 0);
+
+        // Bloque cifrado + desencriptado en lo que queda después del primer bloque
+        size_t avail = mem_cap > 3 * STREAM_PROBE ? mem_cap - STREAM_PROBE : 2 * STREAM_PROBE;
+        r->chunk = avail / 2 / 3 * 3;
+
+        r->head = new uint8_t[STREAM_PROBE];
+        r->head_len = fread(r->head, 1, STREAM_PROBE, r->f);
+        fgetpos(r->f, &r->body);
+        r->enc = new uint8_t[r->chunk];
+        r->dec = new uint8_t[r->chunk > STREAM_PROBE ? r->chunk : STREAM_PROBE];
+        return true;
+    }
+
+    void reader_close(stream_reader_t *r)
+    {
+        fclose(r->f);
+        delete[] r->head;
+        delete[] r->enc;
+        delete[] r->dec;
+    }
+
+    /**
+     * @brief Devuelve el bloque @p i de un recorrido (los bloques se piden en orden desde 0).
+     *
+     * @return Longitud del bloque, o 0 al final del archivo.
+     */
+    size_t reader_block(stream_reader_t *r, size_t i, const uint8_t **block)
+    {
+        if (i == 0)
+        {
+            *block = r->head;
+            return r->head_len;
+        }
+        // fsetpos y no fseek: un long no alcanza para desplazamientos > 2 GB en Windows
+        if (i == 1 && fsetpos(r->f, &r->body) != 0)
+        {
+            return 0;
+        }
+        *block = r->enc;
+        return fread(r->enc, 1, r->chunk, r->f);
+    }
+
+    /**
+     * @brief Prueba un candidato recorriendo el archivo por bloques.
+     *
+     * Aplica las mismas reglas que `try_candidate()`: el clasificador decide qué
+     * decodificadores siguen activos, RLE tiene prioridad sobre LZ78 y una coincidencia solo
+     * cuenta si el flujo completo sigue siendo compatible con su formato, por lo que tras
+     * encontrar el fragmento se sigue clasificando (sin decodificar) hasta que el resultado
+     * ya no pueda cambiar.
+     *
+     * @return CODEC_RLE o CODEC_LZ78 según el formato ganador, o CODEC_NONE.
+     */
+    codec_class_t stream_try_candidate(stream_reader_t *r, const frag_pattern_t *pat,
+                                       uint8_t n, uint8_t k, rle_stream_t *rs, lz78_stream_t *ls)
+    {
+        codec_classifier_t cls;
+        classifier_init(&cls);
+        rle_stream_init(rs);
+        lz78_stream_reset(ls);
+
+        frag_matcher_t rm, lm;
+        matcher_start(&rm, pat, nullptr, 0);
+        matcher_start(&lm, pat, nullptr, 0);
+        bool rle_live = !rm.found;
+        bool lz_live = !lm.found;
+
+        const uint8_t *blk = nullptr;
+        size_t len;
+        for (size_t i = 0; (len = reader_block(r, i, &blk)) > 0; i++)
+        {
+            TRACE_BEGIN(t_dec);
+            decrypt_into(blk, r->dec, len, n, k);
+            TRACE_END(TRACE_DECRYPT, t_dec, len, 0);
+
+            TRACE_BEGIN(t_cls);
+            bool any = classifier_feed(&cls, r->dec, len);
+            TRACE_END(TRACE_CLASSIFY, t_cls, len, !any);
+            if (!any)
+            {
+                return CODEC_NONE;
+            }
+
+            rle_live = rle_live && cls.rle_ok;
+            lz_live = lz_live && cls.lz_ok;
+            if (rle_live && rle_stream_feed(rs, r->dec, len, matcher_sink, &rm) != STREAM_MORE)
+            {
+                rle_live = false; // encontrado o fin del texto
+            }
+            if (lz_live && lz78_stream_feed(ls, r->dec, len, matcher_sink, &lm) != STREAM_MORE)
+            {
+                lz_live = false;
+            }
+
+            bool rle_hit = rm.found && cls.rle_ok;
+            bool lz_hit = lm.found && cls.lz_ok;
+            if (!rle_live && !lz_live)
+            {
+                if (!rle_hit && !lz_hit)
+                {
+                    return CODEC_NONE;
+                }
+                // Los triples restantes ya no pueden cambiar la clasificación
+                bool settled = !(cls.rle_ok && !cls.rle_done) && !cls.lz_ok;
+                if (settled || (rle_hit && cls.rle_done))
+                {
+                    break;
+                }
+            }
+        }
+
+        if (rle_live)
+        {
+            rle_stream_finish(rs, matcher_sink, &rm);
+        }
+        if (lz_live)
+        {
+            lz78_stream_finish(ls, matcher_sink, &lm);
+        }
+
+        if (rm.found && cls.rle_ok)
+        {
+            return CODEC_RLE;
+        }
+        if (lm.found && cls.lz_ok)
+        {
+            return CODEC_LZ78;
+        }
+        return CODEC_NONE;
+    }
+
+    /**
+     * @struct file_sink_t
+     * @brief Destino del mensaje en el modo por bloques.
+     */
+    typedef struct {
+        FILE *out;      /**< Archivo de salida. */
+        size_t len;     /**< Bytes escritos. */
+        bool ok;        /**< No hubo errores de escritura. */
+    } file_sink_t;
+
+    /**
+     * @brief Sink que escribe cada bloque en el archivo; el mensaje termina en el primer NUL.
+     */
+    bool file_sink(const char *chunk, size_t len, void *user)
+    {
+        file_sink_t *fs = (file_sink_t *)user;
+
+        const char *nul = (const char *)memchr(chunk, '\0', len);
+        size_t n = nul ? (size_t)(nul - chunk) : len;
+        if (fwrite(chunk, 1, n, fs->out) != n)
+        {
+            fs->ok = false;
+            return false;
+        }
+        fs->len += n;
+        return fs->ok && !nul;
+    }
+
+    /**
+     * @brief Decodifica por bloques el flujo de la clave ganadora hacia @p out_path.
+     *
+     * @return `true` si el mensaje se escribió completo.
+     */
+    bool stream_write(stream_reader_t *r, codec_class_t codec, uint8_t n, uint8_t k,
+                      rle_stream_t *rs, lz78_stream_t *ls, const char *out_path, size_t *out_len)
+    {
+        file_sink_t fs;
+        fs.out = fopen(out_path, "wb");
+        fs.len = 0;
+        fs.ok = fs.out != nullptr;
+        if (!fs.ok)
+        {
+            fprintf(stderr, "Error: no se pudo crear %s\n", out_path);
+            return false;
+        }
+
+        rle_stream_init(rs);
+        lz78_stream_reset(ls);
+
+        TRACE_BEGIN(t_out);
+        stream_status_t st = STREAM_MORE;
+        const uint8_t *blk = nullptr;
+        size_t len;
+        for (size_t i = 0; st == STREAM_MORE && (len = reader_block(r, i, &blk)) > 0; i++)
+        {
+            decrypt_into(blk, r->dec, len, n, k);
+            st = codec == CODEC_RLE ? rle_stream_feed(rs, r->dec, len, file_sink, &fs)
+                                    : lz78_stream_feed(ls, r->dec, len, file_sink, &fs);
+        }
+        if (st == STREAM_MORE)
+        {
+            st = codec == CODEC_RLE ? rle_stream_finish(rs, file_sink, &fs)
+                                    : lz78_stream_finish(ls, file_sink, &fs);
+        }
+        TRACE_END(codec == CODEC_RLE ? TRACE_RLE_EXPAND : TRACE_LZ78_EXPAND, t_out, fs.len, !fs.ok);
+
+        if (fclose(fs.out) != 0)
+        {
+            fs.ok = false;
+        }
+        if (!fs.ok)
+        {
+            fprintf(stderr, "Error: no se pudo escribir %s\n", out_path);
+        }
+        *out_len = fs.len;
+        return fs.ok;
+    }
+
+    // ====== Claves de varios bytes ============
+
+    /**
+     * @brief Período de las columnas para una clave de @p key_len bytes: `mcm(key_len, 3)`.
+     *
+     * En cada columna `i % período` todos los bytes usan el mismo byte de clave y cumplen
+     * el mismo papel dentro del triple (basura/índice alto, repeticiones/índice bajo o símbolo).
+     */
+    inline size_t key_period(size_t key_len)
+    {
+        return key_len % 3 == 0 ? key_len : 3 * key_len;
+    }
+
+    /**
+     * @brief Histograma de cada columna `i % period` de @p buf.
+     *
+     * @param[in]  buf     Buffer a analizar.
+     * @param[in]  len     Longitud del buffer.
+     * @param[in]  period  Cantidad de columnas (hasta KEY_PERIOD_MAX).
+     * @param[out] hist    `period * 256` contadores: `hist[columna * 256 + byte]`.
+     */
+    void column_histograms(const uint8_t *buf, size_t len, size_t period, size_t *hist)
+    {
+        memset(hist, 0, period * 256 * sizeof(size_t));
+
+        size_t col = 0;
+        for (size_t i = 0; i < len; i++)
+        {
+            hist[col * 256 + buf[i]]++;
+            if (++col == period)
+            {
+                col = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Índice de coincidencia conjunto de las columnas: probabilidad de que dos bytes
+     *        tomados de la misma columna sean iguales.
+     *
+     * La XOR con un byte fijo solo permuta el histograma, así que no cambia el índice. Si
+     * el período separa bien los bytes de clave, cada columna conserva la distribución
+     * concentrada del texto comprimido; si mezcla bytes de clave distintos, se aplana.
+     */
+    double coincidence_index(const size_t *hist, size_t period)
+    {
+        double same = 0.0;
+        double pairs = 0.0;
+        for (size_t c = 0; c < period; c++)
+        {
+            const size_t *h = hist + c * 256;
+            size_t total = 0;
+            for (int b = 0; b < 256; b++)
+            {
+                same += (double)h[b] * (double)(h[b] ? h[b] - 1 : 0);
+                total += h[b];
+            }
+            pairs += (double)total * (double)(total ? total - 1 : 0);
+        }
+        return pairs > 0.0 ? same / pairs : 0.0;
+    }
+
+    /**
+     * @brief Peso de un byte de repeticiones RLE: las corridas cortas son las más comunes
+     *        y cero repeticiones no aparece en un flujo bien formado.
+     */
+    inline int count_weight(uint8_t v)
+    {
+        if (v == 0)
+        {
+            return -4;
+        }
+        return v <= 8 ? 9 - v : 0;
+    }
+
+    /**
+     * @brief Byte de clave que mejor explica las columnas de @p cols según @p weight.
+     *
+     * @param[in]  hist     Histogramas por columna (`column_histograms()`).
+     * @param[in]  cols     Columnas que usan este byte de clave.
+     * @param[in]  n_cols   Cantidad de columnas.
+     * @param[in]  n        Rotación.
+     * @param[in]  weight   Peso de cada byte descifrado.
+     * @param[out] out_k    Mejor byte de clave.
+     *
+     * @return Puntaje del mejor byte de clave.
+     */
+    int64_t best_column_key(const size_t *hist, const size_t *cols, size_t n_cols, uint8_t n,
+                            const int weight[256], uint8_t *out_k)
+    {
+        // Histograma conjunto de las columnas (comparten clave y papel en el triple)
+        size_t h[256] = {0};
+        for (size_t c = 0; c < n_cols; c++)
+        {
+            for (int b = 0; b < 256; b++)
+            {
+                h[b] += hist[cols[c] * 256 + b];
+            }
+        }
+
+        uint8_t present[256];
+        size_t n_present = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            if (h[b])
+            {
+                present[n_present++] = (uint8_t)b;
+            }
+        }
+
+        int64_t best = INT64_MIN;
+        for (int k = 0; k < KEY_SPACE; k++)
+        {
+            int64_t sc = 0;
+            for (size_t p = 0; p < n_present; p++)
+            {
+                uint8_t b = present[p];
+                sc += (int64_t)h[b] * weight[ror_8((uint8_t)(b ^ k), n)];
+            }
+            if (sc > best)
+            {
+                best = sc;
+                *out_k = (uint8_t)k;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Recupera, columna por columna, los bytes de clave que se deciden con histogramas.
+     *
+     * Para cada byte de clave se juntan sus columnas de símbolos y se elige la XOR que mejor
+     * puntúa con `symbol_weight()`: 256 intentos por byte en lugar de 256^L para la clave
+     * completa. Si la longitud es múltiplo de 3 hay bytes de clave que nunca cifran símbolos;
+     * esos se dejan en 0 para `key_fill_high()`, `key_fill_counts()` y `lz78_low_options()`.
+     *
+     * @param[in]  hist     Histogramas de `key_period(key_len)` columnas.
+     * @param[in]  key_len  Longitud de la clave.
+     * @param[in]  n        Rotación.
+     * @param[out] key      Clave de @p key_len bytes.
+     *
+     * @return Puntaje de las columnas de símbolos (ordena las rotaciones).
+     */
+    int64_t key_from_histograms(const size_t *hist, size_t key_len, uint8_t n, uint8_t *key)
+    {
+        size_t period = key_period(key_len);
+
+        int sym_w[256];
+        for (int c = 0; c < 256; c++)
+        {
+            sym_w[c] = symbol_weight((uint8_t)c);
+        }
+
+        int64_t total = 0;
+        for (size_t j = 0; j < key_len; j++)
+        {
+            // Columnas de este byte de clave, separadas por papel en el triple
+            size_t cols[3][3]; // cada byte de clave tiene period / key_len <= 3 columnas
+            size_t n_cols[3] = {0, 0, 0};
+            for (size_t c = j; c < period; c += key_len)
+            {
+                cols[c % 3][n_cols[c % 3]++] = c;
+            }
+
+            if (n_cols[2] > 0)
+            {
+                total += best_column_key(hist, cols[2], n_cols[2], n, sym_w, &key[j]);
+            }
+            else
+            {
+                key[j] = 0; // basura / índice alto, repeticiones / índice bajo: según el formato
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Completa los bytes de clave de la primera posición del triple.
+     *
+     * Solo aplica si @p key_len es múltiplo de 3. En LZ78 es el byte alto del índice y el
+     * token t solo puede referenciar entradas 0..t, así que el byte alto no pasa de t / 256
+     * (es 0 en los primeros 256 tokens). Se elige la XOR que menos viola esa regla en los
+     * primeros KEY_LZ78_TOKENS tokens y, entre esas, la de valores más chicos. En RLE es
+     * basura y no afecta al mensaje; con un compresor que la deja en 0 la regla también la
+     * recupera.
+     */
+    void key_fill_high(const uint8_t *enc, size_t enc_len, size_t key_len, uint8_t n, uint8_t *key)
+    {
+        size_t n_tokens = enc_len / 3;
+        if (n_tokens > KEY_LZ78_TOKENS)
+        {
+            n_tokens = KEY_LZ78_TOKENS;
+        }
+
+        // Costo: cada violación pesa más que la suma de todos los bytes altos posibles
+        const uint64_t violation = (uint64_t)n_tokens * 256;
+
+        for (size_t j = 0; j < key_len; j += 3)
+        {
+            uint64_t best_cost = UINT64_MAX;
+            for (int k = 0; k < KEY_SPACE; k++)
+            {
+                uint64_t cost = 0;
+                for (size_t t = j / 3; t < n_tokens && cost < best_cost; t += key_len / 3)
+                {
+                    size_t hi = ror_8((uint8_t)(enc[3 * t] ^ k), n);
+                    cost += hi > (t >> 8) ? violation : hi;
+                }
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    key[j] = (uint8_t)k;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Completa los bytes de clave de la columna de repeticiones suponiendo RLE.
+     *
+     * Solo aplica si @p key_len es múltiplo de 3 (si no, la columna de símbolos ya fijó
+     * todos los bytes). Se elige la XOR que deja más repeticiones cortas.
+     */
+    void key_fill_counts(const size_t *hist, size_t key_len, uint8_t n, uint8_t *key)
+    {
+        int w[256];
+        for (int c = 0; c < 256; c++)
+        {
+            w[c] = count_weight((uint8_t)c);
+        }
+        for (size_t j = 1; j < key_len; j += 3)
+        {
+            best_column_key(hist, &j, 1, n, w, &key[j]);
+        }
+    }
+
+    /**
+     * @brief Opciones para el byte de clave @p j (columna de índice bajo) suponiendo LZ78.
+     *
+     * El byte bajo no tiene una distribución útil, pero el formato sí lo restringe: el
+     * token t solo puede referenciar entradas 0..t. Con el byte alto ya descifrado (su
+     * byte de clave es el anterior), se cuentan las violaciones de esa regla en los
+     * primeros KEY_LZ78_TOKENS tokens. Los bits bajos quedan poco restringidos, así que se
+     * devuelven todas las claves con el mínimo de violaciones (hasta KEY_LZ78_TIES), primero
+     * las de índices más chicos: las frases cortas (entradas viejas) son las más repetidas.
+     *
+     * @param[in]  enc       Buffer encriptado.
+     * @param[in]  enc_len   Longitud del buffer.
+     * @param[in]  key_len   Longitud de la clave (múltiplo de 3).
+     * @param[in]  n         Rotación.
+     * @param[in]  key       Clave con el byte alto (j - 1) ya elegido.
+     * @param[in]  j         Byte de clave a resolver (j % 3 == 1).
+     * @param[out] opts      Arreglo de KEY_LZ78_TIES posiciones.
+     *
+     * @return Cantidad de opciones (al menos 1).
+     */
+    size_t lz78_low_options(const uint8_t *enc, size_t enc_len, size_t key_len, uint8_t n,
+                            const uint8_t *key, size_t j, uint8_t *opts)
+    {
+        size_t n_tokens = enc_len / 3;
+        if (n_tokens > KEY_LZ78_TOKENS)
+        {
+            n_tokens = KEY_LZ78_TOKENS;
+        }
+
+        size_t bad[KEY_SPACE];
+        uint64_t sum[KEY_SPACE];
+        size_t min_bad = SIZE_MAX;
+        for (int k = 0; k < KEY_SPACE; k++)
+        {
+            bad[k] = 0;
+            sum[k] = 0;
+            for (size_t t = j / 3; t < n_tokens; t += key_len / 3)
+            {
+                size_t hi = ror_8(enc[3 * t] ^ key[j - 1], n);
+                size_t lo = ror_8((uint8_t)(enc[3 * t + 1] ^ k), n);
+                bad[k] += ((hi << 8) | lo) > t;
+                sum[k] += lo;
+            }
+            min_bad = bad[k] < min_bad ? bad[k] : min_bad;
+        }
+
+        uint8_t cand[KEY_SPACE];
+        size_t n_cand = 0;
+        for (int k = 0; k < KEY_SPACE; k++)
+        {
+            if (bad[k] == min_bad)
+            {
+                cand[n_cand++] = (uint8_t)k;
+            }
+        }
+        stable_sort(cand, cand + n_cand, [&sum](uint8_t a, uint8_t b) { return sum[a] < sum[b]; });
+
+        size_t count = n_cand < KEY_LZ78_TIES ? n_cand : KEY_LZ78_TIES;
+        memcpy(opts, cand, count);
+        return count;
+    }
+
+    /**
+     * @brief Prueba una clave completa de varios bytes (ver `try_decrypted()`).
+     */
+    bool try_key(const uint8_t *enc, size_t enc_len, const frag_pattern_t *pat, uint8_t n,
+                 const uint8_t *key, size_t key_len, scratch_t *s, char **out_msg, const char **out_method)
+    {
+        TRACE_BEGIN(t_dec);
+        decrypt_into_key(enc, s->dec, enc_len, n, key, key_len);
+        TRACE_END(TRACE_DECRYPT, t_dec, enc_len, 0);
+
+        return try_decrypted(s->dec, enc_len, pat, nullptr, 0, s, out_msg, out_method);
+    }
+}
+
+void symbol_histogram(const uint8_t *buf, size_t len, size_t sym_hist[256])
+{
+    for (int b = 0; b < 256; b++)
+    {
+        sym_hist[b] = 0;
+    }
+
+    // El tercer byte de cada triple es el símbolo tanto en RLE como en LZ78
+    for (size_t i = 2; i < len; i += 3)
+    {
+        sym_hist[buf[i]]++;
+    }
+}
+
+void rank_candidates(const size_t sym_hist[256], uint16_t *cands, size_t n_cands)
+{
+    if (n_cands < 2)
+    {
+        return;
+    }
+
+    int weight[256];
+    for (int c = 0; c < 256; c++)
+    {
+        weight[c] = symbol_weight((uint8_t)c);
+    }
+
+    // Solo importan los valores presentes en la columna de símbolos
+    uint8_t present[256];
+    size_t n_present = 0;
+    for (int b = 0; b < 256; b++)
+    {
+        if (sym_hist[b])
+        {
+            present[n_present++] = (uint8_t)b;
+        }
+    }
+
+    int64_t *score = new int64_t[N_CANDIDATES];
+    for (size_t i = 0; i < n_cands; i++)
+    {
+        uint8_t n = (uint8_t)(ROT_MIN + cands[i] / KEY_SPACE);
+        uint8_t k = (uint8_t)(cands[i] % KEY_SPACE);
+
+        int64_t sc = 0;
+        for (size_t p = 0; p < n_present; p++)
+        {
+            uint8_t b = present[p];
+            sc += (int64_t)sym_hist[b] * weight[ror_8((uint8_t)(b ^ k), n)];
+        }
+        score[cands[i]] = sc;
+    }
+
+    // Orden estable: con puntajes iguales se conserva el orden (n, k)
+    stable_sort(cands, cands + n_cands, [score](uint16_t a, uint16_t b) { return score[a] > score[b]; });
+    delete[] score;
+}
+
+bool finder(const uint8_t *enc, size_t enc_len, const char *know_fragment, char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k)
+{
+
+    *out_msg = nullptr;
+
+    if (enc_len == 0)
+    {
+        cout << "ERROR, No hay nada texto para analizar.\n";
+        return false;
+    }
+
+    TRACE_BEGIN(t0);
+
+    // Solo se desencriptan los candidatos que superan el porcentaje de imprimibles,
+    // del más al menos probable según la columna de símbolos
+    uint16_t *cands = new uint16_t[N_CANDIDATES];
+    size_t n_cands = prefilter_candidates(enc, enc_len, cands);
+
+    size_t sym_hist[256];
+    symbol_histogram(enc, enc_len, sym_hist);
+    rank_candidates(sym_hist, cands, n_cands);
+
+    bool found = try_list(enc, enc_len, know_fragment, cands, n_cands, out_msg, out_method, out_n, out_k);
+
+    delete[] cands;
+    TRACE_END(TRACE_FINDER, t0, enc_len, !found);
+    return found;
+}
+
+bool finder_parallel(const uint8_t *enc, size_t enc_len, const char *know_fragment, char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k, unsigned int n_threads)
+{
+    *out_msg = nullptr;
+
+    if (n_threads == 0)
+    {
+        n_threads = thread::hardware_concurrency();
+    }
+    if (n_threads > N_CANDIDATES)
+    {
+        n_threads = N_CANDIDATES;
+    }
+    if (n_threads <= 1 || enc_len == 0)
+    {
+        return finder(enc, enc_len, know_fragment, out_msg, out_method, out_n, out_k);
+    }
+
+    TRACE_BEGIN(t0);
+
+    // Los candidatos que pasan el prefiltro quedan en el mismo orden que el recorrido
+    // serial (por probabilidad). Cada hilo toma la siguiente posición libre de la lista y
+    // `best` guarda la menor posición con coincidencia encontrada hasta ahora.
+    uint16_t *cands = new uint16_t[N_CANDIDATES];
+    size_t n_cands = prefilter_candidates(enc, enc_len, cands);
+
+    size_t sym_hist[256];
+    symbol_histogram(enc, enc_len, sym_hist);
+    rank_candidates(sym_hist, cands, n_cands);
+
+    frag_pattern_t pat;
+    pattern_init(&pat, know_fragment);
+
+    atomic<size_t> next(0);
+    atomic<size_t> best(n_cands);
+    mutex result_lock;
+    char *best_msg = nullptr;
+    const char *best_method = nullptr;
+
+    auto worker = [&]()
+    {
+        // Cada hilo reserva su memoria de trabajo una sola vez
+        scratch_t scratch;
+        scratch_init(&scratch, enc_len, &pat);
+
+        for (;;)
+        {
+            size_t i = next.fetch_add(1);
+
+            // Cancelación temprana: ningún candidato posterior al mejor puede ganar
+            if (i >= best.load())
+            {
+                break;
+            }
+
+            uint8_t n = (uint8_t)(ROT_MIN + cands[i] / KEY_SPACE);
+            uint8_t k = (uint8_t)(cands[i] % KEY_SPACE);
+
+            char *msg = nullptr;
+            const char *method = nullptr;
+
+            if (!try_candidate(enc, enc_len, &pat, n, k, &best, i, &scratch, &msg, &method))
+            {
+                continue;
+            }
+
+            // Conservar solo el candidato de menor índice para que el resultado
+            // coincida con el de la búsqueda serial
+            lock_guard<mutex> guard(result_lock);
+            if (i < best.load())
+            {
+                delete[] best_msg;
+                best_msg = msg;
+                best_method = method;
+                best.store(i);
+            }
+            else
+            {
+                delete[] msg;
+            }
+        }
+
+        scratch_free(&scratch);
+    };
+
+    thread *pool = new thread[n_threads];
+    for (unsigned int t = 0; t < n_threads; t++)
+    {
+        pool[t] = thread(worker);
+    }
+    for (unsigned int t = 0; t < n_threads; t++)
+    {
+        pool[t].join();
+    }
+    delete[] pool;
+
+    pattern_free(&pat);
+
+    size_t i = best.load();
+    if (i == n_cands)
+    {
+        delete[] cands;
+        TRACE_END(TRACE_FINDER, t0, enc_len, 1);
+        return false;
+    }
+
+    *out_msg = best_msg;
+    *out_method = dup_method(best_method);
+    *out_n = (uint8_t)(ROT_MIN + cands[i] / KEY_SPACE);
+    *out_k = (uint8_t)(cands[i] % KEY_SPACE);
+    delete[] cands;
+    TRACE_END(TRACE_FINDER, t0, enc_len, 0);
+    return true;
+}
+
+bool finder_known_plaintext(const uint8_t *enc, size_t enc_len, const char *know_fragment, char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k)
+{
+    *out_msg = nullptr;
+
+    if (enc_len == 0 || !know_fragment || !*know_fragment)
+    {
+        return false;
+    }
+
+    TRACE_BEGIN(t0);
+
+    size_t hist[256];
+    size_t sym_hist[256];
+    byte_histogram(enc, enc_len, hist);
+    symbol_histogram(enc, enc_len, sym_hist);
+
+    frag_pattern_t pat;
+    pattern_init(&pat, know_fragment);
+
+    // Un candidato es consistente si lo es con alguna de las alternativas de la pista
+    bool *marks = new bool[N_CANDIDATES]();
+    for (size_t a = 0; a < pat.hm.n_pats; a++)
+    {
+        kpa_mark_rle(enc, enc_len, pat.hm.pats[a], marks);
+        kpa_mark_lz78(enc, enc_len, pat.hm.pats[a], sym_hist, marks);
+    }
+
+    // Candidatos consistentes que pasan el prefiltro, en el mismo orden que la búsqueda
+    // completa: si varios confirman la pista gana el mismo que ganaría `finder()`
+    uint16_t *cands = new uint16_t[N_CANDIDATES];
+    size_t n_cands = 0;
+    for (size_t c = 0; c < N_CANDIDATES; c++)
+    {
+        uint8_t n = (uint8_t)(ROT_MIN + c / KEY_SPACE);
+        uint8_t k = (uint8_t)(c % KEY_SPACE);
+
+        if (marks[c] && printable_ratio(hist, enc_len, n, k, RATIO_MIN))
+        {
+            cands[n_cands++] = (uint16_t)c;
+        }
+    }
+    delete[] marks;
+    rank_candidates(sym_hist, cands, n_cands);
+
+    scratch_t scratch;
+    scratch_init(&scratch, enc_len, &pat);
+
+    bool found = false;
+    for (size_t i = 0; i < n_cands && !found; i++)
+    {
+        uint8_t n = (uint8_t)(ROT_MIN + cands[i] / KEY_SPACE);
+        uint8_t k = (uint8_t)(cands[i] % KEY_SPACE);
+
+        char *msg = nullptr;
+        const char *method = nullptr;
+
+        if (try_candidate(enc, enc_len, &pat, n, k, nullptr, i, &scratch, &msg, &method))
+        {
+            *out_msg = msg;
+            *out_method = dup_method(method);
+            *out_n = n;
+            *out_k = k;
+            found = true;
+        }
+    }
+
+    scratch_free(&scratch);
+    pattern_free(&pat);
+    delete[] cands;
+    TRACE_END(TRACE_FINDER, t0, enc_len, !found);
+    return found;
+}
+
+bool finder_auto(const uint8_t *enc, size_t enc_len, const char *know_fragment, char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k, unsigned int n_threads)
+{
+    // Primero los pocos candidatos que deja el texto conocido y, si ninguno sirve,
+    // la fuerza bruta completa
+    if (finder_known_plaintext(enc, enc_len, know_fragment, out_msg, out_method, out_n, out_k))
+    {
+        return true;
+    }
+    return finder_parallel(enc, enc_len, know_fragment, out_msg, out_method, out_n, out_k, n_threads);
+}
+
+bool finder_keys(const uint8_t *enc, size_t enc_len, const char *know_fragment, const uint16_t *cands, size_t n_cands,
+                 char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_k)
+{
+    *out_msg = nullptr;
+
+    if (enc_len == 0 || n_cands == 0)
+    {
+        return false;
+    }
+
+    TRACE_BEGIN(t0);
+    bool found = try_list(enc, enc_len, know_fragment, cands, n_cands, out_msg, out_method, out_n, out_k);
+    TRACE_END(TRACE_FINDER, t0, enc_len, !found);
+    return found;
+}
+
+bool finder_stream(const char *enc_path, const char *know_fragment, const char *out_path, size_t mem_cap,
+                   char **out_method, uint8_t *out_n, uint8_t *out_k, size_t *out_len)
+{
+    *out_len = 0;
+    if (mem_cap == 0)
+    {
+        mem_cap = STREAM_MEM_DEFAULT;
+    }
+
+    stream_reader_t r;
+    if (!reader_open(&r, enc_path, mem_cap))
+    {
+        return false;
+    }
+
+    TRACE_BEGIN(t0);
+
+    // Pasada 1: histogramas por bloques para el prefiltro y el orden de los candidatos
+    // (los bloques empiezan en múltiplos de 3, así que la columna de símbolos se conserva)
+    size_t hist[256] = {0};
+    size_t sym_hist[256] = {0};
+    size_t part[256];
+    size_t enc_len = 0;
+    const uint8_t *blk = nullptr;
+    size_t len;
+    for (size_t i = 0; (len = reader_block(&r, i, &blk)) > 0; i++)
+    {
+        byte_histogram(blk, len, part);
+        for (int b = 0; b < 256; b++)
+        {
+            hist[b] += part[b];
+        }
+        symbol_histogram(blk, len, part);
+        for (int b = 0; b < 256; b++)
+        {
+            sym_hist[b] += part[b];
+        }
+        enc_len += len;
+    }
+
+    if (enc_len == 0)
+    {
+        reader_close(&r);
+        return false;
+    }
+
+    uint16_t *cands = new uint16_t[N_CANDIDATES];
+    size_t n_cands = prefilter_from_histogram(hist, enc_len, cands);
+    rank_candidates(sym_hist, cands, n_cands);
+
+    frag_pattern_t pat;
+    pattern_init(&pat, know_fragment);
+
+    rle_stream_t *rs = new rle_stream_t;
+    lz78_stream_t ls;
+    lz78_stream_init(&ls);
+
+    // Pasada 2: candidatos en el orden de finder(), cada uno por bloques
+    bool found = false;
+    for (size_t i = 0; i < n_cands && !found; i++)
+    {
+        uint8_t n = (uint8_t)(ROT_MIN + cands[i] / KEY_SPACE);
+        uint8_t k = (uint8_t)(cands[i] % KEY_SPACE);
+
+        codec_class_t codec = stream_try_candidate(&r, &pat, n, k, rs, &ls);
+        if (codec == CODEC_NONE)
+        {
+            continue;
+        }
+
+        // Pasada 3: el mensaje del ganador va directo al archivo
+        found = stream_write(&r, codec, n, k, rs, &ls, out_path, out_len);
+        if (found)
+        {
+            *out_method = dup_method(codec == CODEC_RLE ? "RLE" : "LZ78");
+            *out_n = n;
+            *out_k = k;
+        }
+        break;
+    }
+
+    lz78_stream_free(&ls);
+    delete rs;
+    pattern_free(&pat);
+    delete[] cands;
+    reader_close(&r);
+
+    TRACE_END(TRACE_FINDER, t0, enc_len, !found);
+    return found;
+}
+
+size_t detect_key_length(const uint8_t *enc, size_t enc_len, size_t *out_lens)
+{
+    size_t len = enc_len < KEY_LEN_SAMPLE ? enc_len : KEY_LEN_SAMPLE;
+    size_t *hist = new size_t[KEY_PERIOD_MAX * 256];
+
+    // Longitudes con el mismo período (por ejemplo 2 y 6) tienen las mismas columnas
+    double ic_by_period[KEY_PERIOD_MAX + 1];
+    for (size_t p = 0; p <= KEY_PERIOD_MAX; p++)
+    {
+        ic_by_period[p] = -1.0;
+    }
+
+    double ic[KEY_LEN_MAX + 1];
+    double best = 0.0;
+    for (size_t l = 1; l <= KEY_LEN_MAX; l++)
+    {
+        size_t period = key_period(l);
+        ic[l] = -1.0;
+        if (len / period < KEY_LEN_MIN_COLUMN)
+        {
+            continue; // muy pocos bytes por columna para medir
+        }
+        if (ic_by_period[period] < 0.0)
+        {
+            column_histograms(enc, len, period, hist);
+            ic_by_period[period] = coincidence_index(hist, period);
+        }
+        ic[l] = ic_by_period[period];
+        best = ic[l] > best ? ic[l] : best;
+    }
+    delete[] hist;
+
+    // Los múltiplos de la longitud real también separan bien las columnas: se devuelven
+    // todas las plausibles de menor a mayor y la verificación decide
+    size_t count = 0;
+    for (size_t l = 1; l <= KEY_LEN_MAX; l++)
+    {
+        if (ic[l] > 0.0 && ic[l] >= KEY_LEN_IC_RATIO * best)
+        {
+            out_lens[count++] = l;
+        }
+    }
+    return count;
+}
+
+bool finder_multikey(const uint8_t *enc, size_t enc_len, const char *know_fragment,
+                     char **out_msg, char **out_method, uint8_t *out_n, uint8_t *out_key, size_t *out_key_len)
+{
+    *out_msg = nullptr;
+
+    if (enc_len < 3 || !know_fragment)
+    {
+        return false;
+    }
+
+    TRACE_BEGIN(t0);
+
+    size_t lens[KEY_LEN_MAX];
+    size_t n_lens = detect_key_length(enc, enc_len, lens);
+
+    frag_pattern_t pat;
+    pattern_init(&pat, know_fragment);
+
+    scratch_t scratch;
+    scratch_init(&scratch, enc_len, &pat);
+
+    size_t *hist = new size_t[KEY_PERIOD_MAX * 256];
+    bool found = false;
+
+    for (size_t li = 0; li < n_lens && !found; li++)
+    {
+        size_t key_len = lens[li];
+        if (key_len == 1)
+        {
+            continue; // clave de un byte: la resuelven finder() y compañía
+        }
+
+        column_histograms(enc, enc_len, key_period(key_len), hist);
+
+        // Una clave por rotación; las rotaciones se prueban de la que mejor puntúa a la peor
+        uint8_t keys[ROT_MAX - ROT_MIN + 1][KEY_LEN_MAX];
+        int64_t score[ROT_MAX - ROT_MIN + 1];
+        uint8_t order[ROT_MAX - ROT_MIN + 1];
+        for (uint8_t n = ROT_MIN; n <= ROT_MAX; n++)
+        {
+            score[n - ROT_MIN] = key_from_histograms(hist, key_len, n, keys[n - ROT_MIN]);
+            order[n - ROT_MIN] = n;
+        }
+        stable_sort(order, order + (ROT_MAX - ROT_MIN + 1),
+                    [&score](uint8_t a, uint8_t b) { return score[a - ROT_MIN] > score[b - ROT_MIN]; });
+
+        for (size_t r = 0; r <= ROT_MAX - ROT_MIN && !found; r++)
+        {
+            uint8_t n = order[r];
+            uint8_t *key = keys[n - ROT_MIN];
+            char *msg = nullptr;
+            const char *method = nullptr;
+
+            if (key_len % 3 != 0)
+            {
+                found = try_key(enc, enc_len, &pat, n, key, key_len, &scratch, &msg, &method);
+            }
+            else
+            {
+                // Con longitud múltiplo de 3 la columna de repeticiones / índice bajo depende
+                // del formato: primero la clave de RLE y después las combinaciones de LZ78
+                key_fill_high(enc, enc_len, key_len, n, key);
+                key_fill_counts(hist, key_len, n, key);
+                found = try_key(enc, enc_len, &pat, n, key, key_len, &scratch, &msg, &method);
+
+                uint8_t opts[KEY_LEN_MAX / 3][KEY_LZ78_TIES];
+                size_t n_opts[KEY_LEN_MAX / 3];
+                size_t combos = 1;
+                for (size_t c = 0; c < key_len / 3 && !found; c++)
+                {
+                    n_opts[c] = lz78_low_options(enc, enc_len, key_len, n, key, 3 * c + 1, opts[c]);
+                    combos = combos * n_opts[c] < KEY_LZ78_COMBOS ? combos * n_opts[c] : KEY_LZ78_COMBOS;
+                }
+                for (size_t i = 0; i < combos && !found; i++)
+                {
+                    size_t rest = i;
+                    for (size_t c = 0; c < key_len / 3; c++)
+                    {
+                        key[3 * c + 1] = opts[c][rest % n_opts[c]];
+                        rest /= n_opts[c];
+                    }
+                    found = try_key(enc, enc_len, &pat, n, key, key_len, &scratch, &msg, &method);
+                }
+            }
+
+            if (found)
+            {
+                *out_msg = msg;
+                *out_method = dup_method(method);
+                *out_n = n;
+                memcpy(out_key, key, key_len);
+                *out_key_len = key_len;
+            }
+        }
+    }
+
+    delete[] hist;
+    scratch_free(&scratch);
+    pattern_free(&pat);
+
+    TRACE_END(TRACE_FINDER, t0, enc_len, !found);
+    return found;
 }
@@ -0,0 +1,223 @@
+/**
+ * @file trace.cpp
+ * @brief Implementación de la instrumentación por etapas del solver
+ *
+ * Este modulo contiene:
+ *      - trace_record: Acumula los contadores de una etapa y registra su evento
+ *      - trace_reset / trace_events_enable: Control de los contadores y eventos
+ *      - trace_print_summary: Resumen por etapa
+ *      - trace_write_chrome: Exportación en formato Chrome trace-event
+ * Ademas cuenta con funciones auxiliares:
+ *      - thread_id: Identificador corto y estable del hilo que registra
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <trace.hpp>
+
+#include <atomic>
+#include <chrono>
+
+using namespace std;
+
+namespace
+{
+    /**
+     * @struct trace_counters_t
+     * @brief Contadores atómicos de una etapa, cada uno en su propia línea de caché.
+     */
+    typedef struct alignas(64) {
+        atomic<uint64_t> calls;
+        atomic<uint64_t> rejected;
+        atomic<uint64_t> bytes;
+        atomic<uint64_t> ns;
+    } trace_counters_t;
+
+    /**
+     * @struct trace_event_t
+     * @brief Una llamada registrada para la traza.
+     */
+    typedef struct {
+        uint64_t start_ns;  /**< Inicio de la llamada. */
+        uint64_t dur_ns;    /**< Duración. */
+        uint64_t bytes;     /**< Bytes procesados. */
+        uint32_t tid;       /**< Hilo que la ejecutó. */
+        uint8_t stage;      /**< Etapa (trace_stage_t). */
+        uint8_t rejected;   /**< El candidato se descartó en esta llamada. */
+    } trace_event_t;
+
+    const char *const STAGE_NAMES[TRACE_N_STAGES] = {
+        "finder", "prefilter", "decrypt", "classify", "rle_match", "rle_expand", "lz78_stream", "lz78_expand", "verify",
+    };
+
+    trace_counters_t g_counters[TRACE_N_STAGES];
+
+    // Eventos: se reservan una vez; cada hilo toma la siguiente posición libre
+    trace_event_t *g_events = nullptr;
+    size_t g_events_cap = 0;
+    atomic<size_t> g_events_next(0);
+    atomic<bool> g_events_on(false);
+
+    // Origen de tiempo de la traza
+    uint64_t g_epoch_ns = 0;
+
+    atomic<uint32_t> g_next_tid(1);
+
+    /**
+     * @brief Identificador corto del hilo actual (1, 2, 3... en orden de primer uso).
+     */
+    uint32_t thread_id()
+    {
+        thread_local uint32_t tid = 0;
+        if (tid == 0)
+        {
+            tid = g_next_tid.fetch_add(1);
+        }
+        return tid;
+    }
+
+}
+
+bool trace_compiled()
+{
+#ifdef DESAFIO_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t trace_now_ns()
+{
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+               chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void trace_record(trace_stage_t stage, uint64_t t0, uint64_t bytes, uint64_t rejected)
+{
+    uint64_t dur = trace_now_ns() - t0;
+
+    trace_counters_t &c = g_counters[stage];
+    c.calls.fetch_add(1, memory_order_relaxed);
+    c.rejected.fetch_add(rejected, memory_order_relaxed);
+    c.bytes.fetch_add(bytes, memory_order_relaxed);
+    c.ns.fetch_add(dur, memory_order_relaxed);
+
+    if (!g_events_on.load(memory_order_relaxed))
+    {
+        return;
+    }
+
+    // Las posiciones que exceden la capacidad se cuentan como descartadas al exportar
+    size_t i = g_events_next.fetch_add(1, memory_order_relaxed);
+    if (i < g_events_cap)
+    {
+        trace_event_t &e = g_events[i];
+        e.start_ns = t0;
+        e.dur_ns = dur;
+        e.bytes = bytes;
+        e.tid = thread_id();
+        e.stage = (uint8_t)stage;
+        e.rejected = rejected != 0;
+    }
+}
+
+void trace_reset()
+{
+    for (int s = 0; s < TRACE_N_STAGES; s++)
+    {
+        g_counters[s].calls.store(0);
+        g_counters[s].rejected.store(0);
+        g_counters[s].bytes.store(0);
+        g_counters[s].ns.store(0);
+    }
+    g_events_next.store(0);
+    g_epoch_ns = trace_now_ns();
+}
+
+void trace_events_enable(size_t capacity)
+{
+    g_events_on.store(false);
+    delete[] g_events;
+    g_events = new trace_event_t[capacity];
+    g_events_cap = capacity;
+    g_events_next.store(0);
+    g_epoch_ns = trace_now_ns();
+    g_events_on.store(true);
+}
+
+trace_stats_t trace_stats(trace_stage_t stage)
+{
+    trace_stats_t st;
+    st.calls = g_counters[stage].calls.load();
+    st.rejected = g_counters[stage].rejected.load();
+    st.bytes = g_counters[stage].bytes.load();
+    st.ns = g_counters[stage].ns.load();
+    return st;
+}
+
+const char *trace_stage_name(trace_stage_t stage)
+{
+    return STAGE_NAMES[stage];
+}
+
+void trace_print_summary(FILE *out)
+{
+    if (!trace_compiled())
+    {
+        fprintf(out, "Trazas no compiladas (usar CONFIG+=trace)\n");
+        return;
+    }
+
+    fprintf(out, "%-12s %10s %10s %14s %12s %10s\n", "etapa", "llamadas", "rechazos", "bytes", "ms", "MB/s");
+    for (int s = 0; s < TRACE_N_STAGES; s++)
+    {
+        trace_stats_t st = trace_stats((trace_stage_t)s);
+        if (st.calls == 0)
+        {
+            continue;
+        }
+        double ms = (double)st.ns / 1e6;
+        double mbps = st.ns ? (double)st.bytes * 1e3 / (double)st.ns : 0.0;
+        fprintf(out, "%-12s %10llu %10llu %14llu %12.3f %10.1f\n", STAGE_NAMES[s],
+                (unsigned long long)st.calls, (unsigned long long)st.rejected,
+                (unsigned long long)st.bytes, ms, mbps);
+    }
+}
+
+bool trace_write_chrome(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        fprintf(stderr, "Error: no se pudo crear %s\n", path);
+        return false;
+    }
+
+    size_t total = g_events_next.load();
+    size_t count = total < g_events_cap ? total : g_events_cap;
+
+    // Eventos "X" (completos): tiempos en microsegundos desde el inicio de la traza
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    for (size_t i = 0; i < count; i++)
+    {
+        const trace_event_t &e = g_events[i];
+        double ts = (double)(e.start_ns - g_epoch_ns) / 1e3;
+        fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+                   "\"args\":{\"bytes\":%llu,\"rejected\":%u}}",
+                i ? ",\n" : "", STAGE_NAMES[e.stage], e.tid, ts, (double)e.dur_ns / 1e3,
+                (unsigned long long)e.bytes, (unsigned)e.rejected);
+    }
+    fprintf(f, "\n],\"otherData\":{\"dropped_events\":%zu}}\n", total - count);
+
+    bool ok = fclose(f) == 0;
+    if (!ok)
+    {
+        fprintf(stderr, "Error: no se pudo escribir %s\n", path);
+    }
+    return ok;
+}
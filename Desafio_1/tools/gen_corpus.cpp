@@ -0,0 +1,476 @@
+/**
+ * @file gen_corpus.cpp
+ * @brief Generador de corpus de prueba con claves conocidas.
+ *
+ * Produce pares `EncriptadoN.txt` / `pistaN.txt` con el mismo formato que los del
+ * desafío: un texto sintético se comprime con `rle_compress()` o `lz78_compress()`, se
+ * cifra con `encrypt_buffer()` usando una rotación y una clave aleatorias, y la pista es
+ * un fragmento tomado de una posición aleatoria del texto. Las claves usadas se guardan
+ * en `claves.jsonl` para comparar con la salida del modo por lotes. Con `--key-len L`
+ * (L > 1) se cifra con `encrypt_buffer_key()` y una clave aleatoria de L bytes.
+ *
+ * Con `--verify` no se genera nada: se comprueba que `rle_compress()` y `lz78_compress()`
+ * sean inversos de los descompresores (secuencial y paralelo) en casos borde, como las
+ * corridas de más de 255 caracteres y los textos que terminan a mitad de una frase LZ78,
+ * y que `lz78_decode()` recupere exactos los textos con bytes NUL.
+ *
+ * Uso:
+ * @code{.txt}
+ * ./Desafio_1_gen_corpus --out corpus/ [--count 10] [--size 1M] [--method rle|lz78|mix] [--seed 1] [--key-len 1]
+ * ./Desafio_1_gen_corpus --verify
+ * @endcode
+ *
+ * @authors Julián Sánchez
+ *          Jaider Bedoya
+ *
+ * @date 17/10/2026
+ * @version 1.0
+ */
+
+#include <solver.hpp>
+#include <compress.hpp>
+#include <output.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // Longitud de la pista
+    const size_t FRAG_MIN = 16;
+    const size_t FRAG_MAX = 48;
+
+    /**
+     * @enum gen_method_t
+     * @brief Compresión de los archivos generados.
+     */
+    typedef enum {
+        GEN_RLE,
+        GEN_LZ78,
+        GEN_MIX     /**< Alterna RLE y LZ78. */
+    } gen_method_t;
+
+    /**
+     * @struct gen_opts_t
+     * @brief Opciones de la línea de comandos.
+     */
+    typedef struct {
+        const char *out_dir;    /**< Carpeta de destino (se crea si no existe). */
+        size_t count;           /**< Cantidad de pares. */
+        size_t size;            /**< Tamaño del texto en claro de cada par. */
+        gen_method_t method;    /**< Compresión usada. */
+        uint64_t seed;          /**< Semilla del generador. */
+        size_t key_len;         /**< Bytes de la clave XOR (1 a KEY_LEN_MAX). */
+    } gen_opts_t;
+
+    // Vocabulario del texto sintético
+    const char *const WORDS[] = {
+        "el", "la", "de", "que", "y", "en", "un", "los", "se", "del", "las", "por",
+        "con", "para", "una", "como", "pero", "sus", "mas", "entre", "puntero", "memoria",
+        "arreglo", "clave", "texto", "archivo", "bit", "byte", "rotacion", "compresion",
+        "diccionario", "desafio", "informatica", "dinamica", "Hola", "Mundo", "Quijote",
+    };
+    const size_t N_WORDS = sizeof(WORDS) / sizeof(WORDS[0]);
+
+    /**
+     * @brief Generador pseudoaleatorio rápido y reproducible (xorshift64).
+     */
+    uint64_t next_rand(uint64_t *state)
+    {
+        uint64_t x = *state;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        *state = x;
+        return x;
+    }
+
+    /**
+     * @brief Texto sintético de @p len caracteres imprimibles (sin NUL).
+     *
+     * Para RLE cada letra se repite de 1 a 8 veces, de modo que el texto tenga corridas;
+     * para LZ78 se escriben palabras de un vocabulario fijo, que el diccionario aprovecha.
+     */
+    char *gen_text(size_t len, bool runs, uint64_t *seed)
+    {
+        char *text = new char[len + 1];
+        size_t i = 0;
+        while (i < len)
+        {
+            uint64_t r = next_rand(seed);
+            const char *w = WORDS[r % N_WORDS];
+
+            for (; *w && i < len; w++)
+            {
+                size_t rep = runs ? 1 + (size_t)((r >> 16) % 8) : 1;
+                r = (r >> 3) | (r << 61);
+                for (size_t j = 0; j < rep && i < len; j++)
+                {
+                    text[i++] = *w;
+                }
+            }
+
+            if (i < len)
+            {
+                text[i++] = ((r >> 40) % 12 == 0) ? '\n' : ' ';
+            }
+        }
+        text[len] = '\0';
+        return text;
+    }
+
+    /**
+     * @brief Escribe un buffer completo en un archivo binario.
+     *
+     * @return `true` si se escribieron todos los bytes.
+     */
+    bool write_file(const char *path, const void *data, size_t len)
+    {
+        FILE *f = fopen(path, "wb");
+        if (!f)
+        {
+            fprintf(stderr, "Error: no se pudo crear el archivo %s\n", path);
+            return false;
+        }
+        size_t w = fwrite(data, 1, len, f);
+        bool ok = (fclose(f) == 0) && w == len;
+        if (!ok)
+        {
+            fprintf(stderr, "Error: no se pudo escribir el archivo %s\n", path);
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Interpreta un tamaño con sufijo opcional K, M o G (potencias de 1024).
+     */
+    size_t parse_size(const char *s)
+    {
+        char *end = nullptr;
+        double v = strtod(s, &end);
+        switch (*end)
+        {
+        case 'k': case 'K': v *= 1024.0; break;
+        case 'm': case 'M': v *= 1024.0 * 1024.0; break;
+        case 'g': case 'G': v *= 1024.0 * 1024.0 * 1024.0; break;
+        default: break;
+        }
+        return (size_t)v;
+    }
+
+    /**
+     * @brief Genera el par número @p id y agrega su línea a @p keys.
+     *
+     * @return `true` si se escribieron ambos archivos.
+     */
+    bool gen_pair(const gen_opts_t *opts, size_t id, uint64_t *seed, FILE *keys)
+    {
+        bool use_rle = opts->method == GEN_RLE || (opts->method == GEN_MIX && id % 2 == 1);
+
+        char *text = gen_text(opts->size, use_rle, seed);
+
+        size_t comp_len = 0;
+        uint8_t *comp = use_rle ? rle_compress(text, opts->size, &comp_len)
+                                : lz78_compress(text, opts->size, &comp_len);
+
+        uint64_t r = next_rand(seed);
+        uint8_t n = (uint8_t)(ROT_MIN + r % (ROT_MAX - ROT_MIN + 1));
+        uint8_t k = (uint8_t)(r >> 8);
+        uint8_t key[KEY_LEN_MAX];
+        key[0] = k;
+        for (size_t i = 1; i < opts->key_len; i++)
+        {
+            key[i] = (uint8_t)next_rand(seed);
+        }
+        uint8_t *enc = opts->key_len > 1 ? encrypt_buffer_key(comp, comp_len, n, key, opts->key_len)
+                                         : encrypt_buffer(comp, comp_len, n, k);
+
+        // Pista: fragmento de una posición aleatoria
+        size_t flen = FRAG_MIN + (size_t)((r >> 16) % (FRAG_MAX - FRAG_MIN + 1));
+        if (flen > opts->size)
+        {
+            flen = opts->size;
+        }
+        size_t fpos = (size_t)((r >> 24) % (opts->size - flen + 1));
+
+        char enc_path[4096], hint_path[4096];
+        snprintf(enc_path, sizeof(enc_path), "%s/Encriptado%zu.txt", opts->out_dir, id);
+        snprintf(hint_path, sizeof(hint_path), "%s/pista%zu.txt", opts->out_dir, id);
+
+        bool ok = write_file(enc_path, enc, comp_len) && write_file(hint_path, text + fpos, flen);
+        if (ok)
+        {
+            fprintf(keys, "{\"id\":%zu,\"enc\":\"Encriptado%zu.txt\",\"hint\":\"pista%zu.txt\","
+                          "\"method\":\"%s\",\"n\":%u,\"k\":%u,",
+                    id, id, id, use_rle ? "RLE" : "LZ78", n, k);
+            if (opts->key_len > 1)
+            {
+                fputs("\"key\":\"", keys);
+                for (size_t i = 0; i < opts->key_len; i++)
+                {
+                    fprintf(keys, "%02x", key[i]);
+                }
+                fputs("\",", keys);
+            }
+            fprintf(keys, "\"len\":%zu}\n", opts->size);
+        }
+
+        delete[] text;
+        delete[] comp;
+        delete[] enc;
+        return ok;
+    }
+
+    /**
+     * @brief Comprueba que @p out (terminado en NUL) sea exactamente @p text.
+     */
+    bool same_text(const char *out, const char *text, size_t len)
+    {
+        return out && strlen(out) == len && memcmp(out, text, len) == 0;
+    }
+
+    /**
+     * @brief Comprime @p text con RLE o LZ78 y verifica que los descompresores lo recuperen.
+     *
+     * @return `true` si la descompresión secuencial y la paralela devuelven el texto original.
+     */
+    bool round_trip(const char *name, const char *text, size_t len, bool rle)
+    {
+        size_t comp_len = 0;
+        uint8_t *comp = rle ? rle_compress(text, len, &comp_len) : lz78_compress(text, len, &comp_len);
+
+        char *seq = rle ? rle_decompress(comp, comp_len) : lz78_decompress(comp, comp_len);
+        char *par = rle ? rle_decompress_parallel(comp, comp_len, 4)
+                        : lz78_decompress_parallel(comp, comp_len, 4);
+
+        bool ok = same_text(seq, text, len) && same_text(par, text, len);
+        if (!ok)
+        {
+            fprintf(stderr, "Error: %s (%s, %zu bytes) no sobrevive la compresión\n",
+                    name, rle ? "RLE" : "LZ78", len);
+        }
+
+        delete[] comp;
+        delete[] seq;
+        delete[] par;
+        return ok;
+    }
+
+    /**
+     * @struct copy_ctx_t
+     * @brief Destino del sink de `nul_round_trip()`: copia los bloques a un buffer de tamaño conocido.
+     */
+    typedef struct {
+        char *buf;
+        size_t cap;
+        size_t len;
+    } copy_ctx_t;
+
+    /**
+     * @brief Sink que copia cada bloque en un `copy_ctx_t`; se detiene si no cabe.
+     */
+    bool copy_chunk(const char *chunk, size_t len, void *user)
+    {
+        copy_ctx_t *ctx = (copy_ctx_t *)user;
+        if (ctx->len + len > ctx->cap)
+        {
+            return false;
+        }
+        memcpy(ctx->buf + ctx->len, chunk, len);
+        ctx->len += len;
+        return true;
+    }
+
+    /**
+     * @brief Comprime con LZ78 un texto que puede tener bytes NUL y verifica que `lz78_decode()`
+     * lo recupere exacto con cada tipo de destino (creciente, fijo y por callback), y que
+     * `lz78_decompress()` conserve su semántica de descartar los NUL.
+     */
+    bool nul_round_trip(const char *text, size_t len)
+    {
+        size_t comp_len = 0;
+        uint8_t *comp = lz78_compress(text, len, &comp_len);
+        byte_span_t span = {comp, comp_len};
+        bool ok = true;
+
+        growable_buffer_t grow;
+        decode_sink_t sink = sink_growable(&grow);
+        size_t out_len = 0;
+        ok = lz78_decode(span, &sink, &out_len) == DECODE_OK && out_len == len &&
+             grow.len == len && memcmp(grow.data, text, len) == 0 && ok;
+
+        char *fixed = new char[len + 1];
+        sink = sink_fixed(fixed, len);
+        ok = lz78_decode(span, &sink, &out_len) == DECODE_OK && out_len == len &&
+             memcmp(fixed, text, len) == 0 && ok;
+
+        copy_ctx_t ctx = {fixed, len, 0};
+        memset(fixed, 0x55, len);
+        sink = sink_callback(copy_chunk, &ctx);
+        ok = lz78_decode(span, &sink, &out_len) == DECODE_OK && out_len == len &&
+             ctx.len == len && memcmp(fixed, text, len) == 0 && ok;
+
+        // Semántica heredada: el texto sin sus NUL, como C-string
+        size_t n_text = 0;
+        for (size_t i = 0; i < len; i++)
+        {
+            if (text[i] != '\0')
+            {
+                fixed[n_text++] = text[i];
+            }
+        }
+        char *legacy = lz78_decompress(comp, comp_len);
+        ok = same_text(legacy, fixed, n_text) && ok;
+        delete[] legacy;
+
+        if (!ok)
+        {
+            fprintf(stderr, "Error: texto con NUL (LZ78, %zu bytes) no sobrevive lz78_decode\n", len);
+        }
+
+        delete[] fixed;
+        delete[] comp;
+        return ok;
+    }
+
+    /**
+     * @brief Casos borde de los compresores: corridas largas, frases LZ78 incompletas al final
+     * del texto, diccionario LZ78 lleno y textos sintéticos como los del corpus.
+     *
+     * @return `true` si todos los casos recuperan el texto original.
+     */
+    bool verify_compressors()
+    {
+        bool ok = true;
+
+        // RLE: corridas alrededor del límite de 255 repeticiones por triple
+        const size_t RUNS[] = {1, 2, 254, 255, 256, 257, 510, 511, 512, 1000, 70000};
+        for (size_t r = 0; r < sizeof(RUNS) / sizeof(RUNS[0]); r++)
+        {
+            size_t len = 2 * RUNS[r] + 1;
+            char *text = new char[len + 1];
+            memset(text, 'a', RUNS[r]);
+            text[RUNS[r]] = 'b';
+            memset(text + RUNS[r] + 1, 'c', RUNS[r]);
+            text[len] = '\0';
+            ok = round_trip("corrida", text, len, true) && ok;
+            ok = round_trip("corrida", text, len, false) && ok;
+            delete[] text;
+        }
+
+        // LZ78: textos que terminan dentro de una frase ya conocida o justo al cerrarla
+        const char *const TAILS[] = {"a", "aa", "aaa", "aaaa", "abab", "ababa", "abcabcabc", "abcabcab"};
+        for (size_t t = 0; t < sizeof(TAILS) / sizeof(TAILS[0]); t++)
+        {
+            ok = round_trip("final", TAILS[t], strlen(TAILS[t]), false) && ok;
+            ok = round_trip("final", TAILS[t], strlen(TAILS[t]), true) && ok;
+        }
+
+        // Textos sintéticos: cortos, de cualquier longitud y con el diccionario LZ78 lleno
+        uint64_t seed = 0x9E3779B97F4A7C15ULL;
+        const size_t SIZES[] = {1, 17, 4093, 65536 + 7, 3 * 1024 * 1024 + 1};
+        for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++)
+        {
+            for (int runs = 0; runs < 2; runs++)
+            {
+                char *text = gen_text(SIZES[s], runs != 0, &seed);
+                ok = round_trip("texto", text, SIZES[s], runs != 0) && ok;
+                delete[] text;
+            }
+        }
+
+        // LZ78 con símbolos NUL: en frases nuevas, repetidas, al inicio y al final del texto
+        const size_t NUL_SIZES[] = {1, 2, 5, 4093, 65536 + 7, 300000};
+        for (size_t s = 0; s < sizeof(NUL_SIZES) / sizeof(NUL_SIZES[0]); s++)
+        {
+            size_t len = NUL_SIZES[s];
+            char *text = new char[len];
+            for (size_t i = 0; i < len; i++)
+            {
+                uint8_t v = (uint8_t)(next_rand(&seed) >> 59); // 32 símbolos, NUL frecuente
+                text[i] = v < 8 ? '\0' : (char)('a' + v);
+            }
+            ok = nul_round_trip(text, len) && ok;
+            delete[] text;
+        }
+
+        printf("%s\n", ok ? "Compresores verificados" : "Fallo la verificación de los compresores");
+        return ok;
+    }
+
+}
+
+int main(int argc, char *argv[])
+{
+    gen_opts_t opts = {nullptr, 10, 1024 * 1024, GEN_MIX, 1, 1};
+
+    if (argc == 2 && strcmp(argv[1], "--verify") == 0)
+    {
+        return verify_compressors() ? 0 : 1;
+    }
+
+    for (int a = 1; a + 1 < argc; a += 2)
+    {
+        if (strcmp(argv[a], "--out") == 0)
+        {
+            opts.out_dir = argv[a + 1];
+        }
+        else if (strcmp(argv[a], "--count") == 0)
+        {
+            opts.count = (size_t)strtoull(argv[a + 1], nullptr, 10);
+        }
+        else if (strcmp(argv[a], "--size") == 0)
+        {
+            opts.size = parse_size(argv[a + 1]);
+        }
+        else if (strcmp(argv[a], "--method") == 0)
+        {
+            const char *m = argv[a + 1];
+            opts.method = strcmp(m, "rle") == 0 ? GEN_RLE : strcmp(m, "lz78") == 0 ? GEN_LZ78 : GEN_MIX;
+        }
+        else if (strcmp(argv[a], "--seed") == 0)
+        {
+            opts.seed = (uint64_t)strtoull(argv[a + 1], nullptr, 10);
+        }
+        else if (strcmp(argv[a], "--key-len") == 0)
+        {
+            opts.key_len = (size_t)strtoull(argv[a + 1], nullptr, 10);
+        }
+    }
+
+    if (!opts.out_dir || opts.size == 0 || opts.key_len == 0 || opts.key_len > KEY_LEN_MAX)
+    {
+        fprintf(stderr, "Uso: %s --out <carpeta> [--count N] [--size bytes] [--method rle|lz78|mix] [--seed S]"
+                        " [--key-len 1..%d]\n"
+                        "       %s --verify\n", argv[0], KEY_LEN_MAX, argv[0]);
+        return 1;
+    }
+
+    if (!output_make_dirs(opts.out_dir))
+    {
+        fprintf(stderr, "Error: no se pudo crear la carpeta %s\n", opts.out_dir);
+        return 1;
+    }
+
+    char keys_path[4096];
+    snprintf(keys_path, sizeof(keys_path), "%s/claves.jsonl", opts.out_dir);
+    FILE *keys = fopen(keys_path, "w");
+    if (!keys)
+    {
+        fprintf(stderr, "Error: no se pudo crear el archivo %s\n", keys_path);
+        return 1;
+    }
+
+    // xorshift no admite estado cero
+    uint64_t seed = opts.seed * 0x9E3779B97F4A7C15ULL + 1;
+
+    bool ok = true;
+    for (size_t id = 1; id <= opts.count && ok; id++)
+    {
+        ok = gen_pair(&opts, id, &seed, keys);
+    }
+
+    fclose(keys);
+    return ok ? 0 : 1;
+}
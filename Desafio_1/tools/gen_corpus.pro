@@ -0,0 +1,30 @@
+# Generador de corpus de prueba con claves conocidas (no usa Qt)
+CONFIG  += c++17 console
+CONFIG  -= qt app_bundle
+
+SOURCES += \
+    gen_corpus.cpp \
+    ../src/solver.cpp \
+    ../src/compress.cpp \
+    ../src/kernels.cpp \
+    ../src/trace.cpp \
+    ../src/matcher.cpp \
+    ../src/output.cpp
+
+HEADERS += \
+    ../include/solver.hpp \
+    ../include/compress.hpp \
+    ../include/kernels.hpp \
+    ../include/trace.hpp \
+    ../include/matcher.hpp \
+    ../include/output.hpp
+
+INCLUDEPATH += ../include
+
+trace: DEFINES += DESAFIO_TRACE
+
+# Carpetas de salida
+DESTDIR     = bin        # ejecutable
+OBJECTS_DIR = build      # objetos intermedios (.o)
+
+TARGET = Desafio_1_gen_corpus